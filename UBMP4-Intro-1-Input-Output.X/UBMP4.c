@@ -11,9 +11,11 @@
 #include "xc.h" // XC compiler general include file
 
 #include "stdint.h"  // Include integer definitions
+#include "stddef.h"  // Include NULL definition
 #include "stdbool.h" // Include Boolean (true/false) definitions
 
-#include "UBMP4.h" // Include UBMP4 constant symbol definitions
+#include "UBMP4.h"     // Include UBMP4 constant symbol definitions
+#include "scheduler.h" // Include the millisecond clock for sample times
 
 // TODO Initialize oscillator, ports and other PIC/UBMP hardware features here:
 
@@ -75,7 +77,7 @@ unsigned char ADC_read(void)
 {
     GO = 1;          // Start the conversion by setting Go/~Done bit
     while (GO)       // Wait for the conversion to finish (GO==0)
-        ;            // Terminate the empty while loop
+        NOP();       // (lets time pass in the host build's simulation)
     return (ADRESH); // Return the MSB (upper 8-bits) of the result
 }
 
@@ -89,3 +91,127 @@ unsigned char ADC_read_channel(unsigned char channel)
     ADON = 0;      // Turn the A-D converter off
     return result; // Return the MSB (upper 8-bits) of the result
 }
+
+// Timer-triggered sampling: the interrupt fills ADC_samples[ADC_fill_block] while the
+// main loop reads the other block.
+unsigned char ADC_samples[2][ADC_BLOCK_SIZE];
+unsigned char ADC_fill_block = 0;
+unsigned char ADC_fill_index = 0;
+volatile bool ADC_block_ready = false;
+volatile unsigned int ADC_block_time;
+
+// Enable the ADC on the specified channel and start a conversion on every Timer0
+// overflow. The results are collected by ADC_sample_isr().
+void ADC_start_sampling(unsigned char channel)
+{
+    ADC_select_channel(channel);
+    ADC_fill_index = 0;
+    ADC_block_ready = false;
+    ADCON2 = ADC_TRIGGER_TIMER0; // Auto-conversion on Timer0 overflow
+    PIR1bits.ADIF = 0;
+    PIE1bits.ADIE = 1;           // Interrupt when each conversion completes
+    INTCONbits.PEIE = 1;
+}
+
+// Stop the timer-triggered conversions and turn the ADC off.
+void ADC_stop_sampling(void)
+{
+    PIE1bits.ADIE = 0;
+    ADCON2 = ADC_TRIGGER_NONE;
+    ADON = 0;
+}
+
+// Store the conversion result in the current sample block, swapping blocks when
+// it is full. Call from the interrupt handler when the ADIF flag is set.
+void ADC_sample_isr(void)
+{
+    PIR1bits.ADIF = 0;
+    ADC_samples[ADC_fill_block][ADC_fill_index++] = ADRESH;
+    if (ADC_fill_index == ADC_BLOCK_SIZE)
+    {
+        ADC_block_time = millis();
+        ADC_fill_block ^= 1;
+        ADC_fill_index = 0;
+        ADC_block_ready = true;
+    }
+}
+
+// Return the most recently completed block of samples (or NULL if there isn't a
+// new one) and the millis() time of its last sample.
+unsigned char *ADC_take_sample_block(unsigned int *time)
+{
+    if (!ADC_block_ready)
+        return NULL;
+    PIE1bits.ADIE = 0; // Read the time and block without the interrupt changing them
+    ADC_block_ready = false;
+    *time = ADC_block_time;
+    unsigned char *block = ADC_samples[ADC_fill_block ^ 1];
+    PIE1bits.ADIE = 1;
+    return block;
+}
+
+// Configure PWM1 and Timer2 to make the 38 kHz IR carrier. The carrier runs all
+// the time, but only reaches IRLED (RC5) while IR_carrier_on() has it enabled.
+void IR_carrier_config(void)
+{
+    PWM1CON = 0b00000000;                    // Turn PWM1 off while it is set up
+    PR2 = IR_CARRIER_PR2;                    // Set the carrier period
+    PWM1DCH = IR_CARRIER_DUTY >> 2;          // Set the upper 8 bits of the duty cycle
+    PWM1DCL = (IR_CARRIER_DUTY & 0b11) << 6; // and the lower 2 bits
+    TMR2 = 0;
+    T2CON = 0b00000101;                      // Timer2 on, 1:4 prescaler, 1:1 postscaler
+    PWM1CON = 0b10000000;                    // Enable PWM1, output off until needed
+}
+
+// Switch the carrier onto IRLED. The PWM output overrides the RC5 latch, so
+// LED D4, which shares the pin, glows dimly while the carrier is on.
+void IR_carrier_on(void)
+{
+    PWM1CONbits.PWM1OE = 1;
+}
+
+// Return IRLED (RC5) to its latch.
+void IR_carrier_off(void)
+{
+    PWM1CONbits.PWM1OE = 0;
+}
+
+// Watch the IR demodulator's output with comparator C2 so that a carrier
+// starting wakes the PIC from sleep.
+void IR_wake_enable(void)
+{
+    FVRCON = IR_WAKE_FVRCON;
+    CM2CON1 = IR_WAKE_CM2CON1;
+    CM2CON0 = IR_WAKE_CM2CON0;
+    while (!FVRCONbits.FVRRDY) // Wait for the reference to settle before the comparator
+        NOP();                 // is trusted (lets time pass in the host build's simulation)
+    // Enabling the comparator may have set its flag, and a carrier that is
+    // already there counts as having just started
+    PIR2bits.C2IF = CM2CON0bits.C2OUT;
+    PIE2bits.C2IE = 1;
+}
+
+// Turn the comparator and the voltage reference off again.
+void IR_wake_disable(void)
+{
+    PIE2bits.C2IE = 0;
+    CM2CON0 = 0b00000000;
+    FVRCON = 0b00000000;
+    PIR2bits.C2IF = 0;
+}
+
+// Sleep until an enabled interrupt flag is set, then wait for the PLL. Call
+// with GIE clear.
+void OSC_sleep(void)
+{
+    bool tick = INTCONbits.TMR0IE;
+    INTCONbits.TMR0IE = 0; // A pending tick would stop the PIC going to sleep
+    INTCONbits.PEIE = 1;   // Peripheral interrupts only wake the PIC with PEIE set
+    SLEEP();
+    NOP();
+    // OSCCON and ACTCON keep their settings through sleep, so the HFINTOSC
+    // restarts at 16 MHz and only the PLL's lock has to be waited for
+    while (!PLLRDY)
+        ;
+    INTCONbits.TMR0IE = tick;
+}
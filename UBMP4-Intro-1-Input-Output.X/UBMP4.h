@@ -149,4 +149,110 @@ unsigned char ADC_read(void);
  */
 unsigned char ADC_read_channel(unsigned char);
 
+// ADC auto-conversion (ADCON2 TRIGSEL) trigger sources
+#define ADC_TRIGGER_NONE 0b00000000   // Conversions are only started by setting GO
+#define ADC_TRIGGER_TIMER0 0b00110000 // Start a conversion on each Timer0 overflow
+
+// Timer-triggered ADC sampling fills one of two sample blocks while the other is processed
+#define ADC_BLOCK_SIZE 16
+
+/**
+ * Function: void ADC_start_sampling(unsigned char channel)
+ * 
+ * Enable the ADC on the specified channel and start a conversion on every
+ * Timer0 overflow (each 1 ms scheduler tick). The results are collected by
+ * ADC_sample_isr() into blocks of ADC_BLOCK_SIZE samples.
+ * 
+ * Example usage: ADC_start_sampling(ANQ1);
+ */
+void ADC_start_sampling(unsigned char);
+
+/**
+ * Function: void ADC_stop_sampling(void)
+ * 
+ * Stop the timer-triggered conversions and turn the ADC off.
+ */
+void ADC_stop_sampling(void);
+
+/**
+ * Function: void ADC_sample_isr(void)
+ * 
+ * Store the conversion result in the current sample block. Call from the
+ * interrupt handler when the ADIF flag is set.
+ */
+void ADC_sample_isr(void);
+
+/**
+ * Function: unsigned char *ADC_take_sample_block(unsigned int *time)
+ * 
+ * Return the most recently completed block of samples (or NULL if there is no
+ * new block) and the millis() time of its last sample. The block stays valid
+ * until the next block completes, ADC_BLOCK_SIZE ms later.
+ * 
+ * Example usage: samples = ADC_take_sample_block(&time);
+ */
+unsigned char *ADC_take_sample_block(unsigned int *);
+
+// The IR carrier is made by PWM1 from Timer2 counting Fosc/4 through a 1:4 prescaler:
+// 48 MHz / 4 / 4 / (78 + 1) = 37.97 kHz, with a duty cycle of 105 / (4 * 79) = 1/3
+#define IR_CARRIER_PR2 78
+#define IR_CARRIER_DUTY 105
+
+/**
+ * Function: void IR_carrier_config(void)
+ * 
+ * Configure PWM1 and Timer2 to generate the 38 kHz carrier that the IR
+ * demodulator (U2) of another UBMP4 responds to. The carrier stays off IRLED
+ * until IR_carrier_on() is called.
+ */
+void IR_carrier_config(void);
+
+/**
+ * Function: void IR_carrier_on(void)
+ * 
+ * Send the carrier out of IRLED (RC5), overriding the pin's latch.
+ */
+void IR_carrier_on(void);
+
+/**
+ * Function: void IR_carrier_off(void)
+ * 
+ * Stop the carrier, returning RC5 to its latch (LED D4).
+ */
+void IR_carrier_off(void);
+
+// Port C has no interrupt-on-change, so while the PIC sleeps comparator C2 watches the IR
+// demodulator's output (RC2, which is also C12IN2-) against the 2.048 V fixed voltage reference
+#define IR_WAKE_FVRCON 0b10001000  // FVR on, comparator and DAC buffer at 2x (2.048 V)
+#define IR_WAKE_CM2CON0 0b10000010 // C2 on, low power, hysteresis, output not on a pin
+#define IR_WAKE_CM2CON1 0b10100010 // Interrupt on a rising output, + input FVR, - input C12IN2-
+
+/**
+ * Function: void IR_wake_enable(void)
+ * 
+ * Turn on the fixed voltage reference and comparator C2, so the IR
+ * demodulator's output falling (a carrier starting) sets C2IF and wakes the
+ * PIC from sleep. RC2 stays a digital input for the receiver.
+ */
+void IR_wake_enable(void);
+
+/**
+ * Function: void IR_wake_disable(void)
+ * 
+ * Turn the comparator and the voltage reference off again and clear C2IF.
+ */
+void IR_wake_disable(void);
+
+/**
+ * Function: void OSC_sleep(void)
+ * 
+ * Stop the CPU and the oscillator until an enabled interrupt wakes the PIC:
+ * a pushbutton's interrupt-on-change or an enabled peripheral interrupt, such
+ * as IR_wake_enable()'s. Call with GIE clear, so the waking interrupt waits
+ * for the handler until the caller sets GIE again. Timer0 stops while the
+ * PIC sleeps, so millis() doesn't count the time asleep. Returns once the PLL
+ * has locked again.
+ */
+void OSC_sleep(void);
+
 // TODO - Add additional function prototypes for new functions in UBMP4.c here.
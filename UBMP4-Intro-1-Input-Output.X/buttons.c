@@ -0,0 +1,92 @@
+#include "xc.h"        // Microchip XC8 compiler include file
+#include "stdbool.h"   // Include Boolean (true/false) definition
+#include "UBMP4.h"     // Include UBMP4 constants and functions
+#include "scheduler.h" // Include the millisecond clock
+#include "buttons.h"
+
+struct buttonEvent buttonEvents[BUTTON_EVENT_QUEUE_SIZE];
+volatile unsigned char buttonEventHead = 0; // Only written by the interrupt
+volatile unsigned char buttonEventTail = 0; // Only written by the main loop
+
+// The interrupt's view of the buttons (one bit per pin, 1 = pressed) and when each last changed
+unsigned char capturedButtons = 0;
+unsigned int lastEdgeTimes[4];
+
+// The main loop's view of the buttons, as of the last event it took
+unsigned char buttonsDown = 0;
+
+void initButtons()
+{
+    IOCBP = BUTTON_PINS; // Interrupt on release (rising edge)...
+    IOCBN = BUTTON_PINS; // ...and on press (falling edge)
+    IOCBF = 0;
+    INTCONbits.IOCIE = 1;
+}
+
+void pushButtonEvent(unsigned char button, bool pressed, unsigned int time)
+{
+    unsigned char next = (buttonEventHead + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+    if (next == buttonEventTail)
+        return; // The buffer is full, so this edge is lost
+    buttonEvents[buttonEventHead].button = button;
+    buttonEvents[buttonEventHead].pressed = pressed;
+    buttonEvents[buttonEventHead].time = time;
+    buttonEventHead = next;
+}
+
+// Record an event for each of the given pins whose level differs from what we last captured
+void captureButtons(unsigned char pins)
+{
+    unsigned int now = millis();
+    unsigned char levels = ~PORTB & BUTTON_PINS; // The buttons are active low
+    for (unsigned char button = 2; button <= 5; button++)
+    {
+        unsigned char pin = BUTTON_PIN(button);
+        if ((pins & pin) == 0 || (levels & pin) == (capturedButtons & pin))
+            continue;
+        if (now - lastEdgeTimes[button - 2] < BUTTON_DEBOUNCE_MS)
+            continue; // Still bouncing, checkButtonLevels() will look again later
+        lastEdgeTimes[button - 2] = now;
+        capturedButtons ^= pin;
+        pushButtonEvent(button, (levels & pin) != 0, now);
+    }
+}
+
+void handleButtonInterrupt()
+{
+    unsigned char flags = IOCBF & BUTTON_PINS;
+    IOCBF &= ~flags; // Only clear the flags we've seen so a new edge isn't lost
+    captureButtons(flags);
+}
+
+void handleResetButtonInterrupt()
+{
+    SW1_INTERRUPT_FLAG = 0;
+    pushButtonEvent(1, true, millis());
+}
+
+void checkButtonLevels()
+{
+    captureButtons(BUTTON_PINS);
+}
+
+bool getButtonEvent(struct buttonEvent *event)
+{
+    if (buttonEventTail == buttonEventHead)
+        return false;
+    *event = buttonEvents[buttonEventTail];
+    buttonEventTail = (buttonEventTail + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+
+    if (event->button == 1)
+        return true; // SW1 has no release event, so it isn't tracked
+    if (event->pressed)
+        buttonsDown |= BUTTON_PIN(event->button);
+    else
+        buttonsDown &= ~BUTTON_PIN(event->button);
+    return true;
+}
+
+bool isButtonDown(unsigned char button)
+{
+    return (buttonsDown & BUTTON_PIN(button)) != 0;
+}
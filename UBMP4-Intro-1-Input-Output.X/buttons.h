@@ -0,0 +1,51 @@
+// SW2-SW5 are captured by interrupt-on-change: the interrupt timestamps each debounced press and
+// release into a ring buffer that the main loop drains with getButtonEvent().  The interrupt is the
+// only writer of the head index and the main loop the only writer of the tail index, so neither
+// side needs to disable interrupts.
+
+// SW2-SW5 are on RB4-RB7
+#define BUTTON_PINS 0b11110000
+#define BUTTON_PIN(n) (1 << ((n) + 2))
+
+// Edges closer together than this are contact bounce
+#define BUTTON_DEBOUNCE_MS 10
+
+// The number of events the ring buffer holds.  Must be a power of 2.
+#define BUTTON_EVENT_QUEUE_SIZE 16
+
+struct buttonEvent
+{
+    unsigned char button; // 2-5 for SW2-SW5, or 1 for a press of SW1, which has no release event
+    bool pressed;         // true for a press, false for a release
+    unsigned int time;    // millis() when the edge happened
+};
+
+/**
+ * Enable interrupt-on-change for both edges of SW2-SW5.  Call once at start-up, after initScheduler().
+ */
+void initButtons();
+
+/**
+ * Capture the button edges.  Call from the interrupt handler when an IOCBF flag is set.
+ */
+void handleButtonInterrupt();
+
+/**
+ * Capture a press of SW1 (reset).  Call from the interrupt handler when SW1's IOCAF flag is set.
+ */
+void handleResetButtonInterrupt();
+
+/**
+ * Catch any button that changed during its debounce window.  Call from the interrupt handler on each tick.
+ */
+void checkButtonLevels();
+
+/**
+ * Take the oldest event from the ring buffer.  Returns false when there are none.
+ */
+bool getButtonEvent(struct buttonEvent *event);
+
+/**
+ * Returns true if the button was down as of the last event taken by getButtonEvent()
+ */
+bool isButtonDown(unsigned char button);
@@ -1,139 +1,350 @@
 #include "xc.h"      // Microchip XC8 compiler include file
 #include "stdbool.h" // Definitions for boolean symbols
+#include "stdint.h"  // Include integer definitions
+#include "stddef.h"  // Include NULL definition
 #include "UBMP4.h"   // Include UBMP4 constants and functions
 #include "convenience.h"
+#include "scheduler.h"
 #include "buzzer.h"
 
+unsigned int PERIOD_SCALE = 1000;
+char currentOctave = DEFAULT_OCTAVE;
+unsigned char tempoBpm = DEFAULT_TEMPO_BPM;
+unsigned long MORSE_CODE_DOT_PERIOD = 1000000;
+unsigned char cMajor[] = {C, E, G, TheEnd};
+unsigned char dMajor[] = {D, Fs, A, TheEnd};
+unsigned char eMajor[] = {E, Gs, B, TheEnd};
+
 #define MIN(x, y) x < y ? x : y
 #define MAX(x, y) x < y ? y : x
-unsigned long pow(unsigned long x, char y)
-{
-    unsigned long result = 1;
-    for (char i = 0; i < y; i++)
-        result *= x;
-    return result;
-}
 
-// This is the definition of a function pointer type; so that we can pass in different functions to calculate
-// the period given the current position in the cycle, the total # of cycles and the max period.
-typedef unsigned long (*fPeriodCycleRelation)(unsigned int cycleIndex, unsigned long totalCycles, unsigned long maxPeriod);
+const struct toneEnvelope risingEnvelope = {0, 1, {{0, ENVELOPE_LEVEL_FULL, Linear}}};
+const struct toneEnvelope fallingEnvelope = {ENVELOPE_LEVEL_FULL, 1, {{0, 0, Linear}}};
+const struct toneEnvelope valleyEnvelope = {ENVELOPE_LEVEL_FULL, 2, {{128, 0, EaseOut}, {0, ENVELOPE_LEVEL_FULL, EaseIn}}};
+const struct toneEnvelope hillEnvelope = {0, 2, {{128, ENVELOPE_LEVEL_FULL, EaseOut}, {0, 0, EaseIn}}};
+
+// State of the tone currently being generated by the Timer1 interrupt.  Constant tones reload
+// the timer from toneReload; shaped tones follow their envelope.
+unsigned int toneReload;
+volatile unsigned int toneTotalCycles;
+volatile unsigned int toneCycleIndex;
+bool toneSilent;
+
+// The envelope of a shaped tone, worked out when it starts: each segment's half-cycles and the
+// first and second differences of its half-cycle length, in 16.16 fixed point ticks.  The
+// interrupt adds the differences to tonePeriod as it goes.
+unsigned char envelopeSegmentCount = 0; // 0 for a constant tone
+unsigned char envelopeSegment;
+unsigned int envelopeCycles[MAX_ENVELOPE_SEGMENTS];
+signed long envelopeSlopes[MAX_ENVELOPE_SEGMENTS];
+signed long envelopeCurves[MAX_ENVELOPE_SEGMENTS];
+unsigned int envelopeCyclesLeft;
+signed long tonePeriod;
+signed long toneSlope;
+signed long toneCurve;
+
+// The milliseconds left of a tone that is timed by the tick rather than by counting half-cycles
+volatile unsigned int toneMsRemaining = 0;
+
+// State of the chord synthesizer.  While it has voices Timer1 interrupts at the sample rate
+// instead of once per half-cycle: each voice's phase accumulator advances by its increment and
+// its top bit is that voice's square wave.  The accumulators rely on wrapping at 16 bits.
+unsigned char synthVoiceCount = 0;
+uint16_t synthPhases[SYNTH_VOICES];
+uint16_t synthIncrements[SYNTH_VOICES];
+unsigned char synthError;
 
-// Returns a constant period
-unsigned long constantPeriod(unsigned int cycleIndex, unsigned long totalCycles, unsigned long maxPeriod)
+void initTone()
 {
-    return maxPeriod;
+    T1CON = 0b00110000; // Fosc/4 clock source, 1:8 prescaler, timer stopped
+    PIR1bits.TMR1IF = 0;
+    PIE1bits.TMR1IE = 1;
+    INTCONbits.PEIE = 1;
 }
 
-// Returns a period that starts and ends high but is constant at maxPeriod in the middle
-unsigned long bowlPeriod(unsigned int cycleIndex, unsigned long totalCycles, unsigned long maxPeriod)
+void stopTone()
 {
-    unsigned long margin = totalCycles / 80; // 1.25% of the cycle length
-    if (cycleIndex < margin)
-        return maxPeriod + margin - cycleIndex;
-    if (cycleIndex > totalCycles - margin)
-        return maxPeriod + margin - totalCycles + cycleIndex;
-    return maxPeriod;
+    T1CONbits.TMR1ON = 0;
+    PIR1bits.TMR1IF = 0; // An overflow still waiting would toggle the beeper again
+    BEEPER = 0;
+    toneMsRemaining = 0;
+    synthVoiceCount = 0;
 }
 
-// Returns a period that rises as the cycleIndex rises (linear)
-unsigned long risingPeriod(unsigned int cycleIndex, unsigned long totalCycles, unsigned long maxPeriod)
+bool isTonePlaying()
 {
-    return cycleIndex * maxPeriod / totalCycles;
+    return T1CONbits.TMR1ON;
 }
 
-// Returns a period that falls as the cycleIndex rises (linear)
-unsigned long fallingPeriod(unsigned int cycleIndex, unsigned long totalCycles, unsigned long maxPeriod)
+// Work out one sample of the chord synthesizer
+void handleSynthInterrupt()
 {
-    return maxPeriod - cycleIndex * maxPeriod / totalCycles;
+    // Reload the timer first, adding the ticks counted since the overflow so the time taken to
+    // get here isn't lost.  They are fewer than SYNTH_SAMPLE_TICKS, so TMR1L can't carry.
+    unsigned char late = TMR1L;
+    TMR1H = SYNTH_RELOAD >> 8;
+    TMR1L = (SYNTH_RELOAD & 0xFF) + late;
+
+    // Every voice is mixed, used or not (unused ones have an increment of 0), so each sample
+    // costs the same
+    unsigned char level = 0;
+    for (unsigned char v = 0; v < SYNTH_VOICES; v++)
+    {
+        synthPhases[v] += synthIncrements[v];
+        level += synthPhases[v] >> 15;
+    }
+
+    // The beeper can only be on or off, so turn it on for level / synthVoiceCount of the
+    // samples (a first order sigma-delta modulator)
+    synthError += level;
+    if (synthError >= synthVoiceCount)
+    {
+        synthError -= synthVoiceCount;
+        BEEPER = 1;
+    }
+    else
+        BEEPER = 0;
 }
 
-// Returns a falling, then rising parabolic period
-unsigned long valleyPeriod(unsigned int cycleIndex, unsigned long totalCycles, unsigned long maxPeriod)
+void handleToneInterrupt()
 {
-    unsigned long halfCycle = totalCycles / 2;
-    unsigned long mainPart = halfCycle > cycleIndex ? halfCycle - cycleIndex : cycleIndex - halfCycle;
+    PIR1bits.TMR1IF = 0;
+    if (synthVoiceCount > 0)
+    {
+        handleSynthInterrupt();
+        return;
+    }
+    if (toneCycleIndex >= toneTotalCycles)
+    {
+        stopTone();
+        return;
+    }
 
-    return pow(mainPart, 2) * maxPeriod / pow(halfCycle, 2);
+    if (!toneSilent)
+        BEEPER = !BEEPER;
+
+    // Count up so the timer overflows (and interrupts again) after one half-cycle
+    unsigned int reload = toneReload;
+    if (envelopeSegmentCount > 0)
+    {
+        // Move on once the segment's half-cycles are used up, skipping any that have none
+        while (envelopeCyclesLeft == 0 && envelopeSegment < envelopeSegmentCount)
+        {
+            toneSlope = envelopeSlopes[envelopeSegment];
+            toneCurve = envelopeCurves[envelopeSegment];
+            envelopeCyclesLeft = envelopeCycles[envelopeSegment++];
+        }
+        envelopeCyclesLeft--;
+
+        unsigned int period = MIN_SHAPED_TONE_PERIOD;
+        if (tonePeriod > ((signed long)MIN_SHAPED_TONE_PERIOD << 16))
+            period = tonePeriod >> 16;
+        tonePeriod += toneSlope;
+        toneSlope += toneCurve;
+        reload = 0 - period;
+    }
+    toneCycleIndex++;
+    TMR1H = reload >> 8;
+    TMR1L = reload & 0xFF;
 }
 
-// Returns the opposite of the valleyPeriod
-unsigned long hillPeriod(unsigned int cycleIndex, unsigned long totalCycles, unsigned long maxPeriod)
+void handleToneTick()
 {
-    return maxPeriod - valleyPeriod(cycleIndex, totalCycles, maxPeriod);
+    // Cut the tone on the tick, part way through a cycle if need be, so a low note isn't
+    // stretched by up to a whole period
+    if (toneMsRemaining > 0 && --toneMsRemaining == 0)
+        stopTone();
 }
 
-void _makeSound(unsigned long cycles, unsigned long period, fPeriodCycleRelation f, bool silent)
+void waitForTone()
 {
-    for (unsigned int c = 0; c < cycles; c++)
+    while (isTonePlaying())
     {
-        if (!silent)
-            BEEPER = !BEEPER;
-        unsigned long n = (*f)(c, cycles, period);
-        for (unsigned long p = 0; p < n; p++)
-            ;
+        // The interrupt can't run while we're inside it (or before it is enabled), so poll the flag
+        if (!INTCONbits.GIE && PIR1bits.TMR1IF)
+            handleToneInterrupt();
+        NOP(); // Lets time pass in the host build's simulation
     }
 }
 
-void makeSound(unsigned long cycles, unsigned long period)
+// Start the tone timer with the tone state already set up
+void startToneTimer(bool silent)
 {
-    _makeSound(cycles, period, &constantPeriod, false);
+    toneCycleIndex = 0;
+    toneSilent = silent;
+
+    // Let the timer overflow straight away so the interrupt starts the first half-cycle
+    TMR1H = 0xFF;
+    TMR1L = 0xFF;
+    PIR1bits.TMR1IF = 0;
+    T1CONbits.TMR1ON = 1;
 }
 
-void makeMultipleSound(unsigned long cycles, unsigned long period, unsigned char nTimes)
+// Returns an envelope level of the period as a 16.16 fixed point half-cycle length
+signed long envelopeLevelPeriod(unsigned char level, unsigned long period)
 {
-    for (unsigned int i = 0; i < nTimes; i++)
+    unsigned long ticks = level * period / ENVELOPE_LEVEL_FULL;
+    return (signed long)(ticks > MAX_SHAPED_TONE_PERIOD ? MAX_SHAPED_TONE_PERIOD : ticks) << 16;
+}
+
+// Work out the differences that take a segment's half-cycle length through the given change (in
+// 16.16 fixed point ticks) over its half-cycles.  For the parabolas the second difference is
+// constant: 2 * change / cycles^2.
+void setUpEnvelopeSegment(unsigned char s, signed long change, unsigned int cycles, enum EnvelopeCurve curve)
+{
+    envelopeCycles[s] = cycles;
+    envelopeSlopes[s] = 0;
+    envelopeCurves[s] = 0;
+    if (cycles == 0)
+        return;
+
+    signed long perCycle = change / (signed long)cycles;
+    signed long perCycleSquared = perCycle / (signed long)cycles;
+    switch (curve)
     {
-        makeSound(cycles, period);
-        if (i > 0 && i < nTimes - 1)
-            __delay_ms(300);
+    case Linear:
+        envelopeSlopes[s] = perCycle;
+        break;
+    case EaseIn:
+        envelopeSlopes[s] = perCycleSquared;
+        envelopeCurves[s] = 2 * perCycleSquared;
+        break;
+    case EaseOut:
+        envelopeSlopes[s] = 2 * perCycle - perCycleSquared;
+        envelopeCurves[s] = -2 * perCycleSquared;
+        break;
     }
 }
 
-#ifdef MANUAL_CHORDS
-int chordChunks = 10;
-void _makeChordSound(unsigned long cycles, unsigned long periods[])
+void _makeSound(unsigned long cycles, unsigned long period, const struct toneEnvelope *envelope, bool silent)
 {
-    // Divide the cycles into chunks and repeat the periods to simulate a chord
-    char nNotes = sizeof(periods) / sizeof(periods[0]);
-    char nChunks = chordChunks * nNotes;
-    unsigned long cyclesPerChunk = cycles / nChunks;
-    for (int i = 0; i < nChunks; i++)
+    stopTone();
+    toneReload = 0 - (unsigned int)(period < MIN_TONE_PERIOD ? MIN_TONE_PERIOD : period);
+    toneTotalCycles = cycles;
+    envelopeSegmentCount = 0;
+    if (envelope != NULL)
     {
-        unsigned long period = period[i % nNotes];
-        for (unsigned int c = 0; c < cyclesPerChunk; c++)
+        signed long level = envelopeLevelPeriod(envelope->startLevel, period);
+        tonePeriod = level;
+        unsigned int cyclesLeft = cycles;
+        for (unsigned char s = 0; s < envelope->segmentCount; s++)
         {
-            if (!silent)
-                BEEPER = !BEEPER;
-            for (unsigned long p = 0; p < period; p++)
-                ;
+            const struct envelopeSegment *segment = &envelope->segments[s];
+            unsigned int segmentCycles = cyclesLeft;
+            if (s < envelope->segmentCount - 1 && (cycles * segment->share) >> 8 < cyclesLeft)
+                segmentCycles = (cycles * segment->share) >> 8;
+            cyclesLeft -= segmentCycles;
+
+            signed long endLevel = envelopeLevelPeriod(segment->endLevel, period);
+            setUpEnvelopeSegment(s, endLevel - level, segmentCycles, segment->curve);
+            level = endLevel;
         }
+        envelopeSegment = 0;
+        envelopeCyclesLeft = 0;
+        envelopeSegmentCount = envelope->segmentCount;
     }
+    startToneTimer(silent);
 }
-#endif
-
-#define CLOCK_FREQ 48000000
-unsigned long lowerNotePeriods[] = {
-    // These period values must align with the MusicalNote indexes
-    // Note frequency values attained from https://pages.mtu.edu/~suits/notefreqs.html
-    // The period is calculated by dividing the clock frequency the by note frequency
-    CLOCK_FREQ / 1635 * 100, // C
-    CLOCK_FREQ / 1732 * 100, // Cs
-    CLOCK_FREQ / 1835 * 100, // D
-    CLOCK_FREQ / 1945 * 100, // Ds
-    CLOCK_FREQ / 2060 * 100, // E
-    CLOCK_FREQ / 2183 * 100, // F
-    CLOCK_FREQ / 2312 * 100, // Fs
-    CLOCK_FREQ / 2450 * 100, // G
-    CLOCK_FREQ / 2596 * 100, // Gs
-    CLOCK_FREQ / 2750 * 100, // A
-    CLOCK_FREQ / 2914 * 100, // As
-    CLOCK_FREQ / 3087 * 100, // B
-};
 
-unsigned long calculateNotePeriod(enum MusicalNote note)
+// Play a constant tone from a Timer1 reload value for a number of milliseconds
+void playToneForMs(unsigned int reload, unsigned int lengthMs, bool silent)
 {
-    unsigned long period = 0;
+    stopTone();
+    envelopeSegmentCount = 0;
+    toneReload = reload;
+    toneTotalCycles = 0xFFFF; // The tick stops the tone
+    toneMsRemaining = lengthMs;
+    startToneTimer(silent);
+}
 
+void makeSound(unsigned long cycles, unsigned long period)
+{
+    _makeSound(cycles, period, NULL, false);
+}
+
+void makeShapedSound(unsigned long cycles, unsigned long period, const struct toneEnvelope *envelope)
+{
+    _makeSound(cycles, period, envelope, false);
+}
+
+void makeSweptSound(unsigned long cycles, unsigned long period, unsigned char attack, unsigned char decay,
+                    unsigned char sweepLevel)
+{
+    // The hold takes the half-cycles that the attack and decay leave, so without a decay it is
+    // the last segment
+    struct toneEnvelope envelope = {sweepLevel, decay > 0 ? 3 : 2,
+                                    {{attack, ENVELOPE_LEVEL_FULL, Linear},
+                                     {256 - attack - decay, ENVELOPE_LEVEL_FULL, Linear},
+                                     {decay, sweepLevel, Linear}}};
+    _makeSound(cycles, period, &envelope, false);
+}
+
+// The repeated sound that makeMultipleSound has left to play
+unsigned long repeatedSoundCycles;
+unsigned long repeatedSoundPeriod;
+unsigned char repeatedSoundsRemaining = 0;
+
+void playRepeatedSound()
+{
+    if (repeatedSoundsRemaining == 0)
+        return;
+    repeatedSoundsRemaining--;
+    makeSound(repeatedSoundCycles, repeatedSoundPeriod);
+    if (repeatedSoundsRemaining > 0)
+    {
+        // Start the next one once this one has finished plus a small gap
+        unsigned int lengthMs = repeatedSoundCycles * repeatedSoundPeriod / (TONE_TIMER_FREQ / 1000);
+        scheduleEvent(lengthMs + MULTIPLE_SOUND_GAP_MS, &playRepeatedSound);
+    }
+}
+
+void makeMultipleSound(unsigned long cycles, unsigned long period, unsigned char nTimes)
+{
+    repeatedSoundCycles = cycles;
+    repeatedSoundPeriod = period;
+    repeatedSoundsRemaining = nTimes;
+    playRepeatedSound();
+}
+
+void cancelMultipleSound()
+{
+    repeatedSoundsRemaining = 0;
+    cancelEvent(&playRepeatedSound);
+}
+
+// The half-cycle length of a note in tone timer ticks, rounded, from its octave 0 frequency in
+// hundredths of a Hz.  Each octave up doubles the frequency.
+#define NOTE_HALF_CYCLE(centiHz, octave) \
+    ((TONE_TIMER_FREQ * 50L + ((centiHz##L << (octave)) / 2)) / (centiHz##L << (octave)))
+#define NOTE_RELOAD(centiHz, octave) (unsigned int)(0x10000L - NOTE_HALF_CYCLE(centiHz, octave))
+
+// Note frequency values attained from https://pages.mtu.edu/~suits/notefreqs.html
+// These must align with the MusicalNote indexes.
+#define OCTAVE_RELOADS(octave)                                                     \
+    {                                                                              \
+        NOTE_RELOAD(1635, octave), /* C */  NOTE_RELOAD(1732, octave), /* Cs */    \
+        NOTE_RELOAD(1835, octave), /* D */  NOTE_RELOAD(1945, octave), /* Ds */    \
+        NOTE_RELOAD(2060, octave), /* E */  NOTE_RELOAD(2183, octave), /* F */     \
+        NOTE_RELOAD(2312, octave), /* Fs */ NOTE_RELOAD(2450, octave), /* G */     \
+        NOTE_RELOAD(2596, octave), /* Gs */ NOTE_RELOAD(2750, octave), /* A */     \
+        NOTE_RELOAD(2914, octave), /* As */ NOTE_RELOAD(3087, octave), /* B */     \
+    }
+
+// The Timer1 reload value of every note in every octave, worked out by the compiler so starting
+// a note is a table lookup.  The shortest half-cycle (B8) is 95 ticks.
+const unsigned int noteReloads[MAX_OCTAVE + 1][B + 1] = {
+    OCTAVE_RELOADS(0), OCTAVE_RELOADS(1), OCTAVE_RELOADS(2),
+    OCTAVE_RELOADS(3), OCTAVE_RELOADS(4), OCTAVE_RELOADS(5),
+    OCTAVE_RELOADS(6), OCTAVE_RELOADS(7), OCTAVE_RELOADS(8),
+};
+
+// The reload value used for a Rest.  It is never heard.
+#define REST_RELOAD (0x10000L - 1000)
+
+// Returns the Timer1 reload value for a note in the current octave, or 0 if the note doesn't
+// make a sound (octave changes are applied here)
+unsigned int calculateNoteReload(enum MusicalNote note)
+{
     switch (note)
     {
     case Ou:
@@ -146,136 +357,124 @@ unsigned long calculateNotePeriod(enum MusicalNote note)
         currentOctave = DEFAULT_OCTAVE;
         return 0;
     case Rest:
-        // It shouldn't matter what the period is, as long as the total cycles normalizes to the proper
-        // note length.  We just want the Rest to be silent for the correct length of time.
-        period = CLOCK_FREQ / 62;
-        break;
+        return REST_RELOAD;
     default:
         if (note <= B)
-            period = lowerNotePeriods[note];
-        break;
+            return noteReloads[(unsigned char)currentOctave][note];
+        return 0;
     }
-
-    // We need to adjust the period by the octave (and a preferred scaling value)
-    unsigned long adjustedPeriod = period / pow(2, currentOctave) / PERIOD_SCALE;
-    return adjustedPeriod;
 }
 
-unsigned long calculateNoteLength(unsigned char notePlus)
+unsigned char calculateNoteTicks(unsigned char notePlus)
 {
     enum MusicalNoteLength noteLength = notePlus & ~MUSICAL_NOTE_MASK;
-    unsigned long length = EIGHTH_NOTE_DURATION_CYCLES;
-
     switch (noteLength)
     {
     case QuarterNote:
-        length = length * 2;
-        break;
+        return 2;
     case ThreeEighthNote:
-        length = length * 3;
-        break;
+        return 3;
     case HalfNote:
-        length = length * 4;
-        break;
+        return 4;
     case SixEighthNote:
-        length = length * 6;
-        break;
+        return 6;
     case FullNote:
-        length = length * 8;
-        break;
+        return 8;
     }
-    return length;
+    return 1;
 }
 
-void playNote(unsigned char notePlus)
+unsigned int ticksToMs(unsigned int ticks)
+{
+    unsigned int ticksPerMinute = tempoBpm * TICKS_PER_BEAT;
+    return (ticks * 60000UL + ticksPerMinute / 2) / ticksPerMinute;
+}
+
+unsigned int calculateNoteLength(unsigned char notePlus)
+{
+    return ticksToMs(calculateNoteTicks(notePlus));
+}
+
+void playNoteForMs(unsigned char notePlus, unsigned int lengthMs)
 {
     enum MusicalNote note = notePlus & MUSICAL_NOTE_MASK;
-    unsigned long period = calculateNotePeriod(note);
-    if (period > 0)
-    {
-        unsigned long length = calculateNoteLength(notePlus);
+    unsigned int reload = calculateNoteReload(note);
+    if (reload > 0)
+        playToneForMs(reload, lengthMs, note == Rest);
+}
 
-        // We want the note to play for the precise length of time regardless of the period
-        // so we have to adjust the number of cycles by the period
-        _makeSound(length / period, period, &constantPeriod, note == Rest ? true : false);
-    }
+void playNote(unsigned char notePlus)
+{
+    playNoteForMs(notePlus, calculateNoteLength(notePlus));
+}
+
+// The phase increment of a note for the chord synthesizer, rounded, from its octave 0
+// frequency in hundredths of a Hz.  It is worked out for octave 4 (which keeps the
+// intermediate values within an unsigned long for sample lengths up to 132 ticks) and shifted
+// for the other octaves.
+#define PHASE_INCREMENT(centiHz) \
+    (unsigned int)(((centiHz##UL << 4) * 65536 / 100 * SYNTH_SAMPLE_TICKS + TONE_TIMER_FREQ / 2) / TONE_TIMER_FREQ)
+
+// These must align with the MusicalNote indexes
+const unsigned int notePhaseIncrements[B + 1] = {
+    PHASE_INCREMENT(1635), /* C */  PHASE_INCREMENT(1732), /* Cs */
+    PHASE_INCREMENT(1835), /* D */  PHASE_INCREMENT(1945), /* Ds */
+    PHASE_INCREMENT(2060), /* E */  PHASE_INCREMENT(2183), /* F */
+    PHASE_INCREMENT(2312), /* Fs */ PHASE_INCREMENT(2450), /* G */
+    PHASE_INCREMENT(2596), /* Gs */ PHASE_INCREMENT(2750), /* A */
+    PHASE_INCREMENT(2914), /* As */ PHASE_INCREMENT(3087), /* B */
+};
+
+// Returns the phase increment for a note in the current octave
+unsigned int calculateNoteIncrement(enum MusicalNote note)
+{
+    unsigned int increment = notePhaseIncrements[note];
+    if (currentOctave >= 4)
+        return increment << (currentOctave - 4);
+    return increment >> (4 - currentOctave);
 }
 
-const char chordChunks = 10;
 void playChord(unsigned char notePluses[])
 {
-    // To play a cord we're going to use the first note's duration and splice all the notes into that duration to simulate simultaneous notes being played
-    char nNotes = sizeof(notePluses) / sizeof(notePluses[0]);
-    char nChunks = chordChunks * nNotes;
-    unsigned long length = calculateNoteLength(notePluses[0]);
-    unsigned long lengthPerChunk = length / nChunks;
-    for (int i = 0; i < nChunks; i++)
+    stopTone();
+    unsigned char voices = 0;
+    for (unsigned char i = 0; notePluses[i] != TheEnd && voices < SYNTH_VOICES; i++)
     {
         enum MusicalNote note = notePluses[i] & MUSICAL_NOTE_MASK;
-        unsigned long period = calculateNotePeriod(note);
-        if (period > 0)
-            _makeSound(lengthPerChunk / period, period, &constantPeriod, false);
+        if (note <= B)
+        {
+            synthPhases[voices] = 0;
+            synthIncrements[voices++] = calculateNoteIncrement(note);
+        }
+        else
+            calculateNoteReload(note); // Apply any octave change
     }
+    if (voices == 0)
+        return;
+    for (unsigned char v = voices; v < SYNTH_VOICES; v++)
+        synthIncrements[v] = synthPhases[v] = 0;
+    synthError = 0;
+
+    // The chord lasts as long as its first note
+    toneMsRemaining = calculateNoteLength(notePluses[0]);
+    synthVoiceCount = voices;
+    TMR1H = 0xFF;
+    TMR1L = 0xFF;
+    PIR1bits.TMR1IF = 0;
+    T1CONbits.TMR1ON = 1;
 }
 
 void playMorseCodeDotSound()
 {
-    _makeSound(MORSE_CODE_DOT_CYCLES, MORSE_CODE_DOT_PERIOD / PERIOD_SCALE, &risingPeriod, false);
+    _makeSound(MORSE_CODE_DOT_CYCLES, MORSE_CODE_DOT_PERIOD / PERIOD_SCALE, &risingEnvelope, false);
 }
 
 void playMorseCodeDashSound()
 {
-    _makeSound(MORSE_CODE_DOT_CYCLES * 3, MORSE_CODE_DOT_PERIOD / PERIOD_SCALE, &valleyPeriod, false);
+    _makeSound(MORSE_CODE_DOT_CYCLES * 3, MORSE_CODE_DOT_PERIOD / PERIOD_SCALE, &valleyEnvelope, false);
 }
 
-#define MAX_SONG_LENGTH 200
-// unsigned char testScale[] = {Or, A | FullNote, B | FullNote, Ou, C | FullNote, D | FullNote, E | FullNote, D | FullNote, C | FullNote, Od, B | FullNote, A | FullNote, TheEnd};
-// unsigned char testOctaveUp[] = {Or, C | HalfNote, Ou, C | HalfNote, Ou, C | HalfNote, Ou, C | HalfNote, Ou, C | HalfNote, TheEnd};
-// unsigned char testOctaveDown[] = {Or, C | FullNote, Od, C | FullNote, Od, C | FullNote, TheEnd};
-// unsigned char testRest[] = {Or, C, Rest, C | QuarterNote, Rest | QuarterNote, C | FullNote, Rest | FullNote, C | FullNote, TheEnd};
-unsigned char westworldTheme[] = {Or, E | QuarterNote, F, E | QuarterNote, F, E, D, C | ThreeEighthNote, D | FullNote, D | QuarterNote, E, D | QuarterNote, E, D, C, Od, G | HalfNote, Ou, A | FullNote, TheEnd};
-unsigned char maryHadALittleLamb[] = {Or, B, A, G, A, B, B, B | QuarterNote, A, A, A | QuarterNote, B, Ou, D, D | QuarterNote, Rest | QuarterNote, Od, B, A, G, A, B, B, B | QuarterNote, A, A, B, A, G | QuarterNote, G | HalfNote, TheEnd};
-unsigned char furElise[] = {Or,
-                            E, Ds, E, Ds, E, Od, B, Ou, D, C, Od, A | QuarterNote, Rest,
-                            C, E, A, B | QuarterNote, Rest,
-                            E, Gs, B, Ou, C | QuarterNote, Rest,
-                            Od, E, Ou, E, Ds, E, Ds, E, Od, B, Ou, D, C, Od, A | QuarterNote, Rest,
-                            C, E, A, B | QuarterNote, Rest,
-                            E, Ou, C, Od, B, A | QuarterNote, Rest,
-                            B, Ou, C, D, E | QuarterNote, Rest,
-                            Od, G, Ou, F, E, D | QuarterNote, Rest,
-                            Od, F, Ou, E, D, C | QuarterNote, Rest,
-                            Od, E, Ou, D, C, Od, B | SixEighthNote, Rest | HalfNote,
-                            Ou, E, Ds, E, Ds, E, Od, B, Ou, D, C, Od, A | QuarterNote, Rest,
-                            C, E, A, B | QuarterNote, Rest,
-                            E, Gs, B, Ou, C | QuarterNote, Rest,
-                            Od, E, Ou, E, Ds, E, Ds, E, Od, B, Ou, D, C, Od, A | QuarterNote, Rest,
-                            C, E, A, B | QuarterNote, Rest, E, Ou, C, Od, B, A | SixEighthNote, Rest | HalfNote,
-                            TheEnd};
-unsigned char elCondorPasa[] = {Or,
-                                Od, B, Ou, E, Ds, E, Fs, G, Fs, G, A, B | HalfNote, Rest | QuarterNote,
-                                Ou, D, D | QuarterNote, Od, B | HalfNote, Rest | QuarterNote,
-                                Ou, E, D | QuarterNote, Od, B | HalfNote, Rest,
-                                B, A, G, A, G, E | HalfNote, Rest,
-                                B, A, G, E | ThreeEighthNote, Rest | QuarterNote, Rest,
-                                Od, B, Ou, E, Ds, E, Fs, G, Fs, G, A, B | QuarterNote, A, G | QuarterNote, Rest | QuarterNote,
-                                Ou, E, D | QuarterNote, Od, B | HalfNote, Rest,
-                                Ou, E, D, E | QuarterNote, D, E, D, Od, B | ThreeEighthNote, Rest,
-                                B, A, G, A, G, E | HalfNote, Rest,
-                                TheEnd};
-unsigned char *songs[] = {elCondorPasa, maryHadALittleLamb, westworldTheme, furElise};
-// unsigned char *songs[] = {testScale, testOctaveUp}; //, maryHadALittleLamb, westworldTheme};
-unsigned int currentSongIndex = 0;
-
-void playTestSounds()
+void startMorseCodeTone()
 {
-    unsigned char *song = songs[currentSongIndex];
-    unsigned char i = 0;
-    while (song[i] != TheEnd && i < MAX_SONG_LENGTH)
-    {
-        playNote(song[i++]);
-        __delay_ms(50);
-    }
-
-    currentSongIndex = (currentSongIndex + 1) % (sizeof(songs) / sizeof(songs[0]));
+    _makeSound(0xFFFF, MORSE_CODE_DOT_PERIOD / PERIOD_SCALE, NULL, false);
 }
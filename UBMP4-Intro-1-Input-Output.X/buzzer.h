@@ -1,6 +1,6 @@
 // This magic number is used to scale the calculated period of a note down
 // in order to make the sound audible.
-unsigned int PERIOD_SCALE = 1000;
+extern unsigned int PERIOD_SCALE;
 
 // We use lower 5 bits of an integer to encode the note
 #define MUSICAL_NOTE_BITS 5
@@ -11,7 +11,7 @@ unsigned int PERIOD_SCALE = 1000;
 // Octave configuration
 #define DEFAULT_OCTAVE 4
 #define MAX_OCTAVE 8
-char currentOctave = DEFAULT_OCTAVE;
+extern char currentOctave;
 
 // Here are the enumerated values for the notes for convenience
 enum MusicalNote
@@ -46,34 +46,184 @@ enum MusicalNoteLength
     SixEighthNote = 4 << MUSICAL_NOTE_BITS,
     FullNote = 5 << MUSICAL_NOTE_BITS
 };
-// This is the duration of a quarter note expressed in program-execution cycles.
-// The actual duration of the note played will depend on the processor speed/frequency.
-unsigned long EIGHTH_NOTE_DURATION_CYCLES = 70000;
+
+// The tone generator runs Timer1 from Fosc/4 with a 1:8 prescaler, so one tone timer tick
+// is 32 clock cycles (1.5 MHz at 48 MHz).  All periods passed to the tone functions are
+// half-cycle lengths expressed in these ticks.
+#define TONE_TIMER_CYCLES_PER_TICK 32
+#define TONE_TIMER_FREQ (48000000 / TONE_TIMER_CYCLES_PER_TICK)
+
+// The shortest half-cycle the tone interrupt can keep up with.  Constant tones only reload
+// the timer, so they can be shorter than tones whose shape works out every period.  Shaped
+// tones are worked out in 16.16 fixed point, which limits their longest half-cycle.
+#define MIN_TONE_PERIOD 90
+#define MIN_SHAPED_TONE_PERIOD 150
+#define MAX_SHAPED_TONE_PERIOD 0x7FFF
+
+// Note lengths are counted in ticks of an eighth note, and the tempo in quarter note beats per
+// minute.  MAX_TEMPO_BPM keeps an eighth note longer than the gap the song player leaves
+// between notes.
+#define TICKS_PER_BEAT 2
+#define MIN_TEMPO_BPM 40
+#define MAX_TEMPO_BPM 240
+#define DEFAULT_TEMPO_BPM 100
+#define TEMPO_STEP_BPM 20
+extern unsigned char tempoBpm;
+
+/**
+ * Configure Timer1 as the tone generator.  Call once at start-up, before enabling interrupts.
+ */
+void initTone();
+
+/**
+ * Service the tone timer.  Call from the interrupt handler when the Timer1 flag is set.
+ */
+void handleToneInterrupt();
+
+/**
+ * Time the notes that are played for a number of milliseconds.  Call from the interrupt
+ * handler on every 1 ms tick.
+ */
+void handleToneTick();
+
+/**
+ * Returns true while a tone (or a silent rest) is being generated
+ */
+bool isTonePlaying();
 
 /**
- * Play a musical note
+ * Block until the current tone has finished.  This services the tone timer directly when
+ * interrupts are disabled so it is also safe to call from the interrupt handler.
+ */
+void waitForTone();
+
+/**
+ * Silence the buzzer immediately
+ */
+void stopTone();
+
+/**
+ * Play a musical note.  The note is started in the background and this returns immediately.
  *
  * @param notePlus a combined value that represent the MusicalNote and MusicalNoteLength.
  * For example, a half note G can be encoded as notePlus = G | HalfNote
  */
 void playNote(unsigned char notePlus);
+
+/**
+ * Play a musical note for a number of milliseconds, whatever its MusicalNoteLength
+ */
+void playNoteForMs(unsigned char notePlus, unsigned int lengthMs);
+
+/**
+ * Returns the length of a note in ticks
+ */
+unsigned char calculateNoteTicks(unsigned char notePlus);
+
+/**
+ * Returns the number of milliseconds that a number of ticks last at the current tempo, rounded.
+ * To time a run of notes without the rounding adding up, take the difference of their start
+ * and end ticks counted from the first one.
+ */
+unsigned int ticksToMs(unsigned int ticks);
+
+/**
+ * Returns the length of a note in milliseconds at the current tempo
+ */
+unsigned int calculateNoteLength(unsigned char notePlus);
+
+// Chords are played by a direct digital synthesizer that mixes up to SYNTH_VOICES square waves
+// into the beeper at 1.5 MHz / SYNTH_SAMPLE_TICKS (about 16 kHz)
+#define SYNTH_VOICES 3
+#define SYNTH_SAMPLE_TICKS 94
+#define SYNTH_RELOAD (0x10000L - SYNTH_SAMPLE_TICKS)
+
+/**
+ * Play a chord.  The notes sound together for the length of the first one; the chord is
+ * started in the background and this returns immediately.
+ *
+ * @param notePluses the notes, ending with TheEnd.  Notes beyond SYNTH_VOICES are not played
+ * and Ou/Od/Or change the octave of the notes that follow them.
+ */
 void playChord(unsigned char notePluses[]);
-unsigned char cMajor[] = {C, E, G};
-unsigned char dMajor[] = {D, Fs, A};
-unsigned char eMajor[] = {E, Gs, B};
+extern unsigned char cMajor[];
+extern unsigned char dMajor[];
+extern unsigned char eMajor[];
 
 /**
- * Make a noise on the buzzer with the given params a number of times (nTimes)
+ * Start a noise on the buzzer for the given number of half-cycles of the given period (in tone timer ticks)
  **/
 void makeSound(unsigned long cycles, unsigned long period);
 
+// An envelope shapes a tone's pitch: its half-cycle length starts at startLevel and moves through
+// up to MAX_ENVELOPE_SEGMENTS segments, each taking a share of the tone's half-cycles.  Levels are
+// in ENVELOPE_LEVEL_FULLths of the tone's period, so one envelope fits any pitch and length.  The
+// segments are worked out when the tone starts and the interrupt follows them by adding
+// differences, so a shaped half-cycle costs a few additions.
+#define ENVELOPE_LEVEL_FULL 128
+#define MAX_ENVELOPE_SEGMENTS 3
+
+// How a segment moves from one level to the next: in a straight line, or along a parabola that
+// starts (EaseIn) or ends (EaseOut) flat
+enum EnvelopeCurve
+{
+    Linear,
+    EaseIn,
+    EaseOut
+};
+
+struct envelopeSegment
+{
+    unsigned char share; // the segment's share of the half-cycles in 256ths (the last one takes what is left)
+    unsigned char endLevel;
+    enum EnvelopeCurve curve;
+};
+
+struct toneEnvelope
+{
+    unsigned char startLevel;
+    unsigned char segmentCount;
+    struct envelopeSegment segments[MAX_ENVELOPE_SEGMENTS];
+};
+
+// Rising and falling sweep in a straight line between the shortest half-cycle and the period.
+// Valley drops from the period to the shortest half-cycle and back along a parabola, and hill is
+// its opposite.
+extern const struct toneEnvelope risingEnvelope;
+extern const struct toneEnvelope fallingEnvelope;
+extern const struct toneEnvelope valleyEnvelope;
+extern const struct toneEnvelope hillEnvelope;
+
+/**
+ * Start a noise on the buzzer for the given number of half-cycles, with its pitch following the
+ * envelope around the given period (in tone timer ticks)
+ **/
+void makeShapedSound(unsigned long cycles, unsigned long period, const struct toneEnvelope *envelope);
+
 /**
- * Make a noise multiple times with a small delay between them
+ * Start a noise that sweeps into the given period from sweepLevel (see ENVELOPE_LEVEL_FULL) over
+ * the first attack 256ths of its half-cycles, holds it, then sweeps back to sweepLevel over the
+ * last decay 256ths
+ **/
+void makeSweptSound(unsigned long cycles, unsigned long period, unsigned char attack, unsigned char decay,
+                    unsigned char sweepLevel);
+
+// The silence between the sounds made by makeMultipleSound
+#define MULTIPLE_SOUND_GAP_MS 300
+
+/**
+ * Make a noise multiple times with a small delay between them.  The repeats are played by
+ * scheduled events so this returns immediately.
  **/
 void makeMultipleSound(unsigned long cycles, unsigned long period, unsigned char nTimes);
 
-unsigned long MORSE_CODE_DOT_PERIOD = 40000;
-//#define MORSE_CODE_DOT_PERIOD 60000
+/**
+ * Drop the repeats that makeMultipleSound has still to play
+ **/
+void cancelMultipleSound();
+
+// Morse code tones are scaled by PERIOD_SCALE to give a half-cycle length in tone timer ticks
+extern unsigned long MORSE_CODE_DOT_PERIOD;
 #define MORSE_CODE_DOT_CYCLES 200
 
 /**
@@ -87,6 +237,6 @@ void playMorseCodeDotSound();
 void playMorseCodeDashSound();
 
 /**
- * Play some test sounds
+ * Start the Morse Code tone and keep it going until stopTone() is called
  */
-void playTestSounds();
+void startMorseCodeTone();
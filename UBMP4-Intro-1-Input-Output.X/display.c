@@ -0,0 +1,99 @@
+#include "xc.h"      // Microchip XC8 compiler include file
+#include "stdbool.h" // Include Boolean (true/false) definition
+#include "UBMP4.h"   // Include UBMP4 constants and functions
+#include "lcd.h"
+#include "messageBuffer.h"
+#include "morse.h"
+#include "display.h"
+
+// The elements of the letter in the elements field, as a string for morse_to_char()
+char displayElements[DISPLAY_MAX_ELEMENTS + 1];
+unsigned char displayElementCount = 0;
+// Set when a letter had more elements than fit, so it can't be decoded
+bool displayElementsOverflowed = false;
+
+// The column the next character of text goes in
+unsigned char displayTextColumn = 0;
+
+void showStatus(const char *mode, unsigned int speed, const char *units)
+{
+    unsigned char column = DISPLAY_MODE_COLUMN;
+    for (; *mode != EOS && column < DISPLAY_ELEMENTS_COLUMN; column++)
+        lcdPutChar(DISPLAY_STATUS_ROW, column, *mode++);
+    for (; column < DISPLAY_ELEMENTS_COLUMN; column++)
+        lcdPutChar(DISPLAY_STATUS_ROW, column, ' ');
+
+    // The speed is right aligned, without leading zeros
+    lcdPutChar(DISPLAY_STATUS_ROW, DISPLAY_SPEED_COLUMN, speed >= 100 ? '0' + speed / 100 % 10 : ' ');
+    lcdPutChar(DISPLAY_STATUS_ROW, DISPLAY_SPEED_COLUMN + 1, speed >= 10 ? '0' + speed / 10 % 10 : ' ');
+    lcdPutChar(DISPLAY_STATUS_ROW, DISPLAY_SPEED_COLUMN + 2, '0' + speed % 10);
+    lcdPutString(DISPLAY_STATUS_ROW, DISPLAY_UNITS_COLUMN, units);
+}
+
+void showElement(char element)
+{
+    if (displayElementCount == DISPLAY_MAX_ELEMENTS)
+    {
+        displayElementsOverflowed = true;
+        return;
+    }
+    lcdPutChar(DISPLAY_STATUS_ROW, DISPLAY_ELEMENTS_COLUMN + displayElementCount, element);
+    displayElements[displayElementCount++] = element;
+}
+
+void clearElements()
+{
+    for (unsigned char i = 0; i < displayElementCount; i++)
+        lcdPutChar(DISPLAY_STATUS_ROW, DISPLAY_ELEMENTS_COLUMN + i, ' ');
+    displayElementCount = 0;
+    displayElementsOverflowed = false;
+}
+
+void showChar(char c)
+{
+    if (displayTextColumn == LCD_COLUMNS)
+    {
+        // Make room by scrolling the row left one place
+        for (unsigned char column = 0; column < LCD_COLUMNS - 1; column++)
+            lcdPutChar(DISPLAY_TEXT_ROW, column, lcdScreen[DISPLAY_TEXT_ROW][column + 1]);
+        displayTextColumn--;
+    }
+    lcdPutChar(DISPLAY_TEXT_ROW, displayTextColumn++, c);
+}
+
+void breakText()
+{
+    clearElements();
+    showMessageElement(WORD_SEPARATOR);
+}
+
+// Decode the letter in the elements field, add it to the text and empty the field
+void finishLetter()
+{
+    if (displayElementCount == 0)
+        return;
+    displayElements[displayElementCount] = EOS;
+    char c = displayElementsOverflowed ? 0 : morse_to_char(displayElements);
+    showChar(c != 0 ? c : '?');
+    clearElements();
+}
+
+void showMessageElement(char element)
+{
+    switch (element)
+    {
+    case DOT:
+    case DASH:
+        showElement(element);
+        break;
+    case CHAR_SEPARATOR:
+        finishLetter();
+        break;
+    case WORD_SEPARATOR:
+        finishLetter();
+        // Only one space between words, however the gaps were keyed
+        if (displayTextColumn > 0 && lcdScreen[DISPLAY_TEXT_ROW][displayTextColumn - 1] != ' ')
+            showChar(' ');
+        break;
+    }
+}
@@ -0,0 +1,53 @@
+// The LCD (see lcd.h) shows what the board is doing:
+//
+//   row 1  the mode, the elements of the letter being keyed, sent or received, and the speed
+//   row 2  the text that has been keyed, sent or received.  Characters are added on the right,
+//          scrolling the row left once it is full.
+//
+// Everything is written into the LCD's screen copy, so only the cells that change are sent to the
+// LCD and nothing here waits for it.
+
+// Where the fields of the status row are
+#define DISPLAY_MODE_COLUMN 0
+#define DISPLAY_ELEMENTS_COLUMN 4
+#define DISPLAY_SPEED_COLUMN 10
+#define DISPLAY_UNITS_COLUMN 13
+
+// The longest letter the elements field can show
+#define DISPLAY_MAX_ELEMENTS 6
+
+#define DISPLAY_STATUS_ROW 0
+#define DISPLAY_TEXT_ROW 1
+
+/**
+ * Show the mode (up to 4 characters) and the speed (up to 999) with its units (3 characters).
+ * Only the fields that change are updated, so this can be called on every pass of the main loop.
+ */
+void showStatus(const char *mode, unsigned int speed, const char *units);
+
+/**
+ * Add a DOT or DASH to the elements field
+ */
+void showElement(char element);
+
+/**
+ * Empty the elements field
+ */
+void clearElements();
+
+/**
+ * Add a character to the end of the text row
+ */
+void showChar(char c);
+
+/**
+ * Empty the elements field and start a new word in the text, e.g. when what is being shown changes
+ */
+void breakText();
+
+/**
+ * Show an element of a keyed or sent message (DOT, DASH, CHAR_SEPARATOR or WORD_SEPARATOR).  Dots
+ * and dashes are added to the elements field, and at a separator the letter they make up is
+ * decoded and added to the text.
+ */
+void showMessageElement(char element);
@@ -0,0 +1,941 @@
+/*==============================================================================
+ File: benchmark.c
+
+ Timing benchmarks for the buzzer and Morse code paths, run on the host build.
+ Each result is written to standard output as one JSON object per line:
+
+   {"bench":"pitch", ...}   the pitch of every note in every octave as played
+                            through Timer1, against its equal temperament
+                            target, and the spread of its half-cycle lengths
+   {"bench":"morse", ...}   the lengths of the sent marks and spaces, against
+                            the 1/3/7 unit lengths they should have
+   {"bench":"sidetone", ...} how far the sidetone's first and last beeper edges
+                            are from the start and end of each sent mark
+   {"bench":"ir_carrier", ...} the IR carrier's frequency, and how far it
+                            starts and stops from the start and end of each
+                            sent mark
+   {"bench":"ir_loopback", ...} text sent in fast infrared mode with the IR
+                            carrier looped back into the IR demodulator, as
+                            decoded by the receiver, and whether the LCD was
+                            written while the IR demodulator was receiving
+   {"bench":"tempo", ...}   the time between the starts of the notes of a song
+                            played by the song player at several tempos,
+                            against the length of each note at that tempo
+   {"bench":"note_length", ...} how far the length of the lowest and highest
+                            notes of each octave is from the length asked for
+   {"bench":"lcd", ...}     how long a full screen and a single changed cell
+                            take to reach the LCD, and whether the LCD ended
+                            up showing the screen without being written to
+                            before it was ready
+   {"bench":"serial", ...}  whether a line typed into the USB serial port faster
+                            than the firmware reads it arrives whole, and
+                            how many main loop passes it took
+   {"bench":"storage", ...} how many flash rows are erased and written to save a
+                            run of setting changes, the longest the main loop
+                            stops for while they are saved, and whether the
+                            settings and a full message come back after a
+                            reset
+   {"bench":"message_room", ...} the status row as the message fills up, and
+                            whether the message is sent once it is full
+   {"bench":"sleep", ...}   how much of a long idle spell the PIC sleeps for, and
+                            how long after a button press or an IR carrier
+                            wakes it the firmware reacts
+   {"bench":"light_ambient", ...} whether the light input decodes anything
+                            from steady light when the receiver starts, and
+                            whether the LCD was written in a way that
+                            upsets its samples
+   {"bench":"light_receive", ...} text shone onto the light sensor in Morse code,
+                            as the LCD shows it after the first word and at
+                            the end, and whether the LCD upset the samples
+   {"bench":"light_display", ...} the LCD's status row part way through a letter
+                            received on the light input: the mode, the
+                            letter's elements so far and the speed
+   {"bench":"host_call", ...} how long a call takes on the host, in nanoseconds.
+                            This is not PIC timing: the virtual clock only
+                            moves in the firmware's waits and delays, and none
+                            of these calls wait, so only runs on the same
+                            machine can be compared
+   {"bench":"summary", ...} the number of pitch, Morse, sidetone, IR, tempo,
+                            note length, LCD, serial, storage, message room,
+                            sleep and light results that are outside their
+                            tolerances (each of those also has "ok":false)
+
+ Pitch and Morse timing are measured on the virtual clock, so they are what
+ the PIC's timers would produce. Call costs can only be measured on the
+ host's CPU, so they are a relative measure for catching regressions, not a
+ count of PIC instruction cycles.
+==============================================================================*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#include "xc.h"
+#include "hostHardware.h"
+#include "../UBMP4.h"
+#include "../buttons.h"
+#include "../buzzer.h"
+#include "../messageBuffer.h"
+#include "../morse.h"
+#include "../senderMode.h"
+#include "../keyer.h"
+#include "../receiverMode.h"
+#include "../songPlayer.h"
+#include "../lcd.h"
+#include "../display.h"
+#include "../serial.h"
+#include "../usbCdc.h"
+#include "../settings.h"
+
+// How far a note may be from its target pitch, and a mark or space from its target length
+#define PITCH_TOLERANCE_CENTS 10
+#define MORSE_TOLERANCE_MS 1
+#define TEMPO_TOLERANCE_MS 1
+#define SIDETONE_TOLERANCE_MS 1
+#define CARRIER_TOLERANCE_HZ 380 // 1%, well inside the IR demodulator's pass band
+
+static unsigned int failures = 0;
+
+// Not declared in buzzer.h
+unsigned int calculateNoteReload(enum MusicalNote note);
+
+// Not declared in songPlayer.h.  The tempo benchmark plays westworldTheme, which has no
+// repeats to follow.
+extern const unsigned char *const songs[];
+#define TEMPO_SONG_INDEX 2
+
+static const char *const noteNames[] = {"C", "Cs", "D", "Ds", "E", "F", "Fs", "G", "Gs", "A", "As", "B"};
+
+// The beeper edges and LED4 changes seen since the last reset of these counters.  A tone is cut
+// on the tick, so its last half-cycle may be short: the half-cycle lengths only count the ones
+// up to the edge before the last.
+static unsigned long long firstEdge, previousEdge, lastEdge;
+static unsigned long edges;
+static unsigned long long minHalfCycle, maxHalfCycle;
+static unsigned long long led4ChangedAt;
+
+// The start of each note: the first beeper edge after a silence of at least this long
+#define NOTE_ONSET_GAP_MS (SONG_NOTE_GAP_MS / 2)
+#define MAX_ONSETS 64
+static unsigned long long onsets[MAX_ONSETS];
+static unsigned int onsetCount;
+
+// The mark and space lengths sent, by the number of units they should be (up to 7, with room to
+// show ones that are too long)
+#define MAX_UNITS 10
+static double elementTotalMs[2][MAX_UNITS + 1];
+static double elementMinMs[2][MAX_UNITS + 1];
+static double elementMaxMs[2][MAX_UNITS + 1];
+static unsigned int elementCount[2][MAX_UNITS + 1];
+
+// The beeper edges seen during the current mark, and the furthest the sidetone has started or
+// ended from its mark
+static bool markOn = false;
+static unsigned long long markFirstEdge, markLastEdge;
+static double worstSidetoneStartMs, worstSidetoneEndMs;
+static unsigned int sidetoneMarks;
+
+// The marks the IR carrier was sent for, the furthest its starts and stops have been from LED4's,
+// and how often it changed without LED4
+static unsigned int carrierMarks, carrierMismatches;
+static double worstCarrierMs;
+static double carrierHz;
+
+// While set the IR carrier is fed back into the IR demodulator
+static bool infraredLoopback = false;
+
+static void resetEdges(void)
+{
+    edges = 0;
+    minHalfCycle = ~0ull;
+    maxHalfCycle = 0;
+}
+
+static void recordElement(bool mark, double ms)
+{
+    unsigned int units = (unsigned int)(ms / UNIT_LENGTH_MS + 0.5);
+    if (units < 1 || units > MAX_UNITS)
+        return;
+    if (elementCount[mark][units] == 0 || ms < elementMinMs[mark][units])
+        elementMinMs[mark][units] = ms;
+    if (elementCount[mark][units] == 0 || ms > elementMaxMs[mark][units])
+        elementMaxMs[mark][units] = ms;
+    elementTotalMs[mark][units] += ms;
+    elementCount[mark][units]++;
+}
+
+static void outputChanged(unsigned char output, bool on)
+{
+    unsigned long long now = hostGetCycles();
+    if (output == HOST_BEEPER)
+    {
+        if (edges == 0)
+            firstEdge = now;
+        else if (edges > 1)
+        {
+            unsigned long long halfCycle = lastEdge - previousEdge;
+            if (halfCycle < minHalfCycle)
+                minHalfCycle = halfCycle;
+            if (halfCycle > maxHalfCycle)
+                maxHalfCycle = halfCycle;
+        }
+        if (markOn)
+        {
+            if (markFirstEdge == 0)
+                markFirstEdge = now;
+            markLastEdge = now;
+        }
+        if ((edges == 0 || now - lastEdge >= NOTE_ONSET_GAP_MS * HOST_CYCLES_PER_MS) && onsetCount < MAX_ONSETS)
+            onsets[onsetCount++] = now;
+        previousEdge = lastEdge;
+        lastEdge = now;
+        edges++;
+    }
+    else if (output == 4)
+    {
+        // LED4 turning off ends a mark, turning on ends a space
+        if (led4ChangedAt > 0)
+            recordElement(!on, (double)(now - led4ChangedAt) / HOST_CYCLES_PER_MS);
+        if (!on && markOn && markFirstEdge > 0)
+        {
+            double startMs = (double)(markFirstEdge - led4ChangedAt) / HOST_CYCLES_PER_MS;
+            double endMs = (double)(now - markLastEdge) / HOST_CYCLES_PER_MS;
+            if (startMs > worstSidetoneStartMs)
+                worstSidetoneStartMs = startMs;
+            if (endMs > worstSidetoneEndMs)
+                worstSidetoneEndMs = endMs;
+            sidetoneMarks++;
+        }
+        markOn = on;
+        markFirstEdge = 0;
+        led4ChangedAt = now;
+    }
+    else if (output == HOST_IR_CARRIER)
+    {
+        if (infraredLoopback)
+            hostSetInfrared(on);
+        else if (on != markOn)
+            carrierMismatches++;
+        else
+        {
+            // LED4 changes are reported first when both change together
+            double ms = (double)(now - led4ChangedAt) / HOST_CYCLES_PER_MS;
+            if (ms > worstCarrierMs)
+                worstCarrierMs = ms;
+            if (on)
+            {
+                carrierHz = hostInfraredCarrierHz();
+                carrierMarks++;
+            }
+        }
+    }
+}
+
+static void benchmarkPitch(void)
+{
+    for (char octave = 1; octave <= MAX_OCTAVE; octave++)
+    {
+        for (unsigned char note = C; note <= B; note++)
+        {
+            currentOctave = octave;
+            resetEdges();
+            playNote(note);
+            while (isTonePlaying())
+                hostDelayCycles(HOST_CYCLES_PER_MS);
+
+            double halfCycle = (double)(previousEdge - firstEdge) / (edges - 2);
+            double achievedHz = HOST_CYCLES_PER_SECOND / (halfCycle * 2);
+            double targetHz = 440.0 * exp2(octave - 4 + (note - (int)A) / 12.0);
+            double errorCents = 1200 * log2(achievedHz / targetHz);
+            bool ok = fabs(errorCents) <= PITCH_TOLERANCE_CENTS;
+            failures += !ok;
+            printf("{\"bench\":\"pitch\",\"note\":\"%s\",\"octave\":%d,\"target_hz\":%.2f,"
+                   "\"achieved_hz\":%.2f,\"error_cents\":%.2f,\"half_cycle_cycles\":%.1f,"
+                   "\"jitter_cycles\":%llu,\"ok\":%s}\n",
+                   noteNames[note], octave, targetHz, achievedHz, errorCents, halfCycle,
+                   maxHalfCycle - minHalfCycle, ok ? "true" : "false");
+        }
+    }
+    currentOctave = DEFAULT_OCTAVE;
+}
+
+static void benchmarkMorse(void)
+{
+    // "PARIS " is the standard word for timing Morse code: 50 units long
+    const unsigned int words = 3;
+    startTransmittingText("PARIS");
+    led4ChangedAt = 0;
+    unsigned long long end = hostGetCycles() + words * 50ull * UNIT_LENGTH_MS * HOST_CYCLES_PER_MS;
+    while (hostGetCycles() < end)
+    {
+        runMorseCode();
+        hostDelayCycles(200);
+    }
+    stopTransmitting();
+
+    for (unsigned char mark = 0; mark <= 1; mark++)
+    {
+        for (unsigned int units = 1; units <= MAX_UNITS; units++)
+        {
+            unsigned int n = elementCount[mark][units];
+            if (n == 0)
+                continue;
+            double meanMs = elementTotalMs[mark][units] / n;
+            // Marks are 1 or 3 units and spaces 1, 3 or 7
+            bool ok = (units == 1 || units == 3 || (!mark && units == 7)) &&
+                      fabs(meanMs - units * UNIT_LENGTH_MS) <= MORSE_TOLERANCE_MS;
+            failures += !ok;
+            printf("{\"bench\":\"morse\",\"element\":\"%s\",\"units\":%u,\"count\":%u,\"target_ms\":%u,"
+                   "\"mean_ms\":%.3f,\"jitter_ms\":%.3f,\"ok\":%s}\n",
+                   mark ? "mark" : "space", units, n, units * UNIT_LENGTH_MS, meanMs,
+                   elementMaxMs[mark][units] - elementMinMs[mark][units], ok ? "true" : "false");
+        }
+    }
+
+    bool ok = sidetoneMarks > 0 && worstSidetoneStartMs <= SIDETONE_TOLERANCE_MS &&
+              worstSidetoneEndMs <= SIDETONE_TOLERANCE_MS;
+    failures += !ok;
+    printf("{\"bench\":\"sidetone\",\"marks\":%u,\"worst_start_ms\":%.3f,\"worst_end_ms\":%.3f,\"ok\":%s}\n",
+           sidetoneMarks, worstSidetoneStartMs, worstSidetoneEndMs, ok ? "true" : "false");
+
+    ok = carrierMarks == sidetoneMarks && carrierMismatches == 0 &&
+         fabs(carrierHz - 38000) <= CARRIER_TOLERANCE_HZ && worstCarrierMs <= SIDETONE_TOLERANCE_MS;
+    failures += !ok;
+    printf("{\"bench\":\"ir_carrier\",\"marks\":%u,\"carrier_hz\":%.1f,\"worst_edge_ms\":%.3f,"
+           "\"mismatches\":%u,\"ok\":%s}\n",
+           carrierMarks, carrierHz, worstCarrierMs, carrierMismatches, ok ? "true" : "false");
+}
+
+// Every word received must be intact, from the first
+#define LOOPBACK_WORDS 8
+
+static void benchmarkInfraredLoopback(void)
+{
+    char text[LOOPBACK_WORDS * 6 + 1];
+    unsigned int length = 0;
+    char c;
+
+    currentReceiverSource = InfraredInput;
+    startReceiver();
+    unsigned int conflicts = hostGetLcdPinConflicts();
+    infraredLoopback = true;
+    fastInfraredMode = true;
+    startTransmittingText("PARIS");
+    unsigned long long end = hostGetCycles() + LOOPBACK_WORDS * 50ull * FAST_INFRARED_UNIT_MS * HOST_CYCLES_PER_MS;
+    while (hostGetCycles() < end)
+    {
+        runMorseCode();
+        decodeReceivedSignal();
+        while (getReceivedChar(&c) && length < sizeof(text) - 1)
+            text[length++] = c;
+        hostDelayCycles(200);
+    }
+    stopTransmitting();
+    fastInfraredMode = false;
+    sidetoneEnabled = true;
+    infraredLoopback = false;
+    hostSetInfrared(false);
+    stopReceiver();
+    conflicts = hostGetLcdPinConflicts() - conflicts;
+    text[length] = EOS;
+
+    // Count the words that came through intact.  The last one may have been cut off by the end.
+    unsigned int words = 0, intact = 0;
+    char *word = text;
+    for (unsigned int i = 0; i < length; i++)
+    {
+        if (text[i] != ' ')
+            continue;
+        text[i] = EOS;
+        words++;
+        intact += strcmp(word, "PARIS") == 0;
+        text[i] = ' ';
+        word = text + i + 1;
+    }
+    bool ok = words >= LOOPBACK_WORDS - 1 && intact == words && conflicts == 0;
+    failures += !ok;
+    printf("{\"bench\":\"ir_loopback\",\"unit_ms\":%u,\"wpm\":%u,\"words\":%u,\"words_intact\":%u,"
+           "\"text\":\"%s\",\"lcd_conflicts\":%u,\"ok\":%s}\n",
+           FAST_INFRARED_UNIT_MS, WPM_UNIT_LENGTH_MS / FAST_INFRARED_UNIT_MS, words, intact, text,
+           conflicts, ok ? "true" : "false");
+}
+
+static void benchmarkTempo(void)
+{
+    static const unsigned char tempos[] = {MIN_TEMPO_BPM, DEFAULT_TEMPO_BPM, 137, MAX_TEMPO_BPM};
+    const unsigned char *song = songs[TEMPO_SONG_INDEX];
+    for (unsigned char t = 0; t < sizeof(tempos); t++)
+    {
+        tempoBpm = tempos[t];
+        currentSongIndex = TEMPO_SONG_INDEX;
+        resetEdges();
+        onsetCount = 0;
+        playSong();
+        while (isSongLoaded())
+        {
+            runMorseCode();
+            hostDelayCycles(200);
+        }
+        while (isTonePlaying())
+            hostDelayCycles(HOST_CYCLES_PER_MS);
+
+        // Compare the time from the first note to the start of each of the others with the
+        // song's length in ticks up to that note
+        double msPerTick = 60000.0 / (tempoBpm * TICKS_PER_BEAT);
+        unsigned int ticks = 0, notes = 0;
+        double worstMs = 0;
+        for (unsigned char i = 0; song[i] != TheEnd && notes < onsetCount; i++)
+        {
+            unsigned char code = song[i] & SONG_PITCH_MASK;
+            if (code == Rest)
+                ticks += calculateNoteTicks(song[i]);
+            if (code >= Rest)
+                continue;
+            double errorMs = (double)(onsets[notes] - onsets[0]) / HOST_CYCLES_PER_MS - ticks * msPerTick;
+            if (fabs(errorMs) > fabs(worstMs))
+                worstMs = errorMs;
+            ticks += calculateNoteTicks(song[i]);
+            notes++;
+        }
+        bool ok = notes == onsetCount && fabs(worstMs) <= TEMPO_TOLERANCE_MS;
+        failures += !ok;
+        printf("{\"bench\":\"tempo\",\"bpm\":%u,\"notes\":%u,\"ms_per_tick\":%.3f,"
+               "\"worst_error_ms\":%.3f,\"ok\":%s}\n",
+               tempoBpm, notes, msPerTick, worstMs, ok ? "true" : "false");
+    }
+    tempoBpm = DEFAULT_TEMPO_BPM;
+}
+
+// Play the lowest and highest notes of each octave for a set time, and time them from the call
+// until the tone stops.  The tick counts the time down, so a note can be up to a tick short but
+// should never run on past it.
+#define NOTE_LENGTH_MS 200
+#define NOTE_LENGTH_STEP_CYCLES 100
+
+static void benchmarkNoteLength(void)
+{
+    double worstMs = 0;
+    unsigned long lateEdges = 0;
+    for (char octave = 1; octave <= MAX_OCTAVE; octave++)
+    {
+        for (unsigned char note = C; note <= B; note += B - C)
+        {
+            currentOctave = octave;
+            unsigned long long start = hostGetCycles();
+            playNoteForMs(note, NOTE_LENGTH_MS);
+            while (isTonePlaying())
+                hostDelayCycles(NOTE_LENGTH_STEP_CYCLES);
+            double errorMs = (double)(hostGetCycles() - start) / HOST_CYCLES_PER_MS - NOTE_LENGTH_MS;
+            if (fabs(errorMs) > fabs(worstMs))
+                worstMs = errorMs;
+
+            // Nothing should move the beeper once the tone has stopped
+            resetEdges();
+            hostDelayCycles(10 * HOST_CYCLES_PER_MS);
+            lateEdges += edges;
+        }
+    }
+    currentOctave = DEFAULT_OCTAVE;
+    bool ok = worstMs <= NOTE_LENGTH_STEP_CYCLES / (double)HOST_CYCLES_PER_MS &&
+              worstMs >= -(1 + NOTE_LENGTH_STEP_CYCLES / (double)HOST_CYCLES_PER_MS) && lateEdges == 0;
+    failures += !ok;
+    printf("{\"bench\":\"note_length\",\"length_ms\":%u,\"worst_error_ms\":%.3f,"
+           "\"late_edges\":%lu,\"ok\":%s}\n",
+           NOTE_LENGTH_MS, worstMs, lateEdges, ok ? "true" : "false");
+}
+
+// Write to the screen and time how long the tick takes to copy it to the LCD.  The main loop
+// isn't run, so the status display doesn't change the screen as well.
+static void benchmarkLcdFlush(const char *name, const char *row1, const char *row2)
+{
+    unsigned long long start = hostGetCycles();
+    lcdPutString(0, 0, row1);
+    lcdPutString(1, 0, row2);
+    while (!isLcdFlushed())
+        hostDelayCycles(200);
+    double flushMs = (double)(hostGetCycles() - start) / HOST_CYCLES_PER_MS;
+
+    bool shown = true;
+    char text[17];
+    for (unsigned char row = 0; row < LCD_ROWS; row++)
+    {
+        hostGetLcdRow(row, text);
+        shown = shown && memcmp(text, lcdScreen[row], LCD_COLUMNS) == 0;
+    }
+    bool ok = shown && hostGetLcdTimingErrors() == 0;
+    failures += !ok;
+    printf("{\"bench\":\"lcd\",\"update\":\"%s\",\"flush_ms\":%.3f,\"timing_errors\":%u,"
+           "\"ok\":%s}\n",
+           name, flushMs, hostGetLcdTimingErrors(), ok ? "true" : "false");
+}
+
+static void benchmarkLcd(void)
+{
+    benchmarkLcdFlush("full screen", "0123456789ABCDEF", "FEDCBA9876543210");
+    benchmarkLcdFlush("one cell", "0123456789ABCDEF", "FEDCBA98X6543210");
+    lcdClear();
+}
+
+// Type a line longer than the input buffer's free space and read it back, taking what has come
+// in only on every third pass.  The USB driver must hold packets back rather than drop them.
+static void benchmarkSerial(void)
+{
+    static const char line[] = "THE QUICK BROWN FOX JUMPS OVER";
+    hostSerialInput(line);
+    hostSerialInput("\r");
+
+    const char *received = NULL;
+    unsigned int passes;
+    for (passes = 1; passes <= 100 && received == NULL; passes++)
+    {
+        serviceUsbCdc();
+        if (passes % 3 == 0)
+            received = getSerialLine();
+    }
+    bool ok = received != NULL && strcmp(received, line) == 0;
+    failures += !ok;
+    printf("{\"bench\":\"serial\",\"chars\":%u,\"passes\":%u,\"ok\":%s}\n",
+           (unsigned int)strlen(line), passes - 1, ok ? "true" : "false");
+}
+
+// Run the main loop, keeping track of its longest pass
+static void runMainLoop(unsigned int ms, double *longestPassMs)
+{
+    unsigned long long end = hostGetCycles() + ms * HOST_CYCLES_PER_MS;
+    while (hostGetCycles() < end)
+    {
+        unsigned long long start = hostGetCycles();
+        runMorseCode();
+        double passMs = (double)(hostGetCycles() - start) / HOST_CYCLES_PER_MS;
+        if (passMs > *longestPassMs)
+            *longestPassMs = passMs;
+        hostDelayCycles(200);
+    }
+}
+
+#define STORAGE_SAVES 20
+
+// Change the tempo and let it be saved, again and again, then reset the PIC and check that the
+// last tempo, the keyer speed and the message are restored.  The message is the longest that is
+// saved, so it mustn't crowd out the settings.
+static void benchmarkStorage(void)
+{
+    static const char pattern[] = "...---.../";
+    char message[MAX_MESSAGE_LENGTH + 1];
+    for (unsigned int i = 0; i < sizeof(message) - 1; i++)
+        message[i] = pattern[i % (sizeof(pattern) - 1)];
+    message[sizeof(message) - 1] = EOS;
+    hostEraseFlash();
+    hostPowerOn();
+    setupMorseCode();
+    unsigned int erases = hostGetFlashErases();
+    unsigned int writes = hostGetFlashWrites();
+    unsigned int errors = hostGetFlashErrors();
+
+    keyerUnitMs = 100;
+    for (unsigned int i = 0; message[i] != EOS; i++)
+        pushMessageElement(message[i]);
+    double longestPassMs = 0;
+    for (unsigned int save = 0; save < STORAGE_SAVES; save++)
+    {
+        tempoBpm = save % 2 ? MIN_TEMPO_BPM : MAX_TEMPO_BPM;
+        runMainLoop(SETTINGS_SETTLE_MS + 2 * SETTINGS_CHECK_MS, &longestPassMs);
+    }
+    unsigned char savedTempoBpm = tempoBpm;
+    erases = hostGetFlashErases() - erases;
+    writes = hostGetFlashWrites() - writes;
+
+    hostPowerOn();
+    setupMorseCode();
+    bool restored = tempoBpm == savedTempoBpm && keyerUnitMs == 100 && getMessageLength() == strlen(message);
+    for (unsigned int i = 0; restored && message[i] != EOS; i++)
+        restored = getMessageElement(i) == message[i];
+    errors = hostGetFlashErrors() - errors;
+
+    bool ok = restored && errors == 0;
+    failures += !ok;
+    printf("{\"bench\":\"storage\",\"saves\":%u,\"row_erases\":%u,\"row_writes\":%u,"
+           "\"longest_pass_ms\":%.3f,\"errors\":%u,\"message_elements\":%u,\"restored\":%s,"
+           "\"ok\":%s}\n",
+           STORAGE_SAVES, erases, writes, longestPassMs, errors, MAX_MESSAGE_LENGTH,
+           restored ? "true" : "false", ok ? "true" : "false");
+
+    // Leave the firmware as it was at power on for the call benchmarks
+    hostEraseFlash();
+    hostPowerOn();
+    setupMorseCode();
+}
+
+#define SLEEP_IDLE_MS 30000
+// The PIC must sleep through most of the idle spell, all but the wait before it goes to sleep
+#define MIN_ASLEEP_FRACTION 0.9
+// The firmware must react within a pass or two of the PLL locking, after the receiver's glitch
+// filter for a carrier
+#define WAKE_TOLERANCE_MS 1.0
+
+// Run the main loop with sleeps lasting until a wake-up or the end of the time
+static void runSleeping(unsigned int ms)
+{
+    unsigned long long end = hostGetCycles() + ms * HOST_CYCLES_PER_MS;
+    hostSetSleepLimit(end);
+    while (hostGetCycles() < end)
+    {
+        runMorseCode();
+        hostDelayCycles(200);
+    }
+}
+
+// Returns the milliseconds until LED4 turns on, giving up after a second
+static double msUntilLed4(void)
+{
+    unsigned long long start = hostGetCycles();
+    hostSetSleepLimit(start + HOST_CYCLES_PER_SECOND);
+    while (!LED4 && hostGetCycles() - start < HOST_CYCLES_PER_SECOND)
+    {
+        runMorseCode();
+        hostDelayCycles(200);
+    }
+    return (double)(hostGetCycles() - start) / HOST_CYCLES_PER_MS;
+}
+
+static void pressTogether(unsigned char a, unsigned char b)
+{
+    hostSetButton(a, true);
+    hostSetButton(b, true);
+    runSleeping(100);
+    hostSetButton(a, false);
+    hostSetButton(b, false);
+    runSleeping(100);
+}
+
+// Change modes with SW2 and SW5 until the receiver is running, then switch inputs with SW3 until
+// it is using source.  The RAM isn't cleared by hostPowerOn(), so the mode and input the firmware
+// starts with depend on what ran before.
+static void enterReceiverMode(enum receiverSource source)
+{
+    for (unsigned char i = 0; i < 3 && memcmp(lcdScreen[DISPLAY_STATUS_ROW], "RX", 2) != 0; i++)
+        pressTogether(2, 5);
+    if (currentReceiverSource != source)
+    {
+        hostSetButton(3, true);
+        runSleeping(50);
+        hostSetButton(3, false);
+    }
+}
+
+// Key the last few elements of a message that is nearly full.  The status row must count down
+// the elements left, and the message must be sent once it is full.
+static void benchmarkMessageRoom(void)
+{
+    hostEraseFlash();
+    hostPowerOn();
+    setupMorseCode();
+    for (unsigned char i = 0; i < 3 && lcdScreen[DISPLAY_STATUS_ROW][0] != 'K'; i++)
+        pressTogether(2, 5);
+    for (unsigned int i = 0; i < MAX_MESSAGE_LENGTH - LOW_MESSAGE_ROOM / 2; i++)
+        pushMessageElement(DOT);
+
+    char expected[5], nearlyFull[17], full[17];
+    snprintf(expected, sizeof(expected), "K %-2u", LOW_MESSAGE_ROOM / 2);
+    runSleeping(100);
+    hostGetLcdRow(DISPLAY_STATUS_ROW, nearlyFull);
+    for (unsigned char i = 0; i < LOW_MESSAGE_ROOM / 2; i++)
+    {
+        hostSetButton(3, true);
+        runSleeping(50);
+        hostSetButton(3, false);
+        runSleeping(50);
+    }
+    hostGetLcdRow(DISPLAY_STATUS_ROW, full);
+    bool ok = strncmp(nearlyFull, expected, 4) == 0 && strncmp(full, "TX  ", 4) == 0;
+    failures += !ok;
+    printf("{\"bench\":\"message_room\",\"elements\":%u,\"nearly_full\":\"%s\",\"full\":\"%s\","
+           "\"ok\":%s}\n",
+           MAX_MESSAGE_LENGTH, nearlyFull, full, ok ? "true" : "false");
+    stopTransmitting();
+}
+
+static void benchmarkSleep(void)
+{
+    hostEraseFlash();
+    hostPowerOn();
+    setupMorseCode();
+    runSleeping(SLEEP_IDLE_MS);
+    unsigned int sleeps = hostGetSleeps();
+    double asleep = (double)hostGetCyclesAsleep() / hostGetCycles();
+
+    // SW3 flashes LED4 in Diagnostic mode
+    hostSetButton(3, true);
+    double buttonMs = msUntilLed4();
+    hostSetButton(3, false);
+
+    // The receiver lights LED4 for a mark, once it has lasted past the glitch filter
+    pressTogether(2, 5);
+    pressTogether(2, 5);
+    runSleeping(SLEEP_IDLE_MS);
+    bool asleepInReceiver = hostGetSleeps() > sleeps;
+    hostSetInfrared(true);
+    double infraredMs = msUntilLed4();
+    hostSetInfrared(false);
+
+    double pllMs = (double)HOST_PLL_LOCK_CYCLES / HOST_CYCLES_PER_MS;
+    bool ok = sleeps == 1 && asleep >= MIN_ASLEEP_FRACTION && asleepInReceiver &&
+              buttonMs <= pllMs + WAKE_TOLERANCE_MS &&
+              infraredMs <= pllMs + RECEIVER_GLITCH_MS + WAKE_TOLERANCE_MS;
+    failures += !ok;
+    printf("{\"bench\":\"sleep\",\"idle_ms\":%u,\"sleeps\":%u,\"asleep_fraction\":%.3f,"
+           "\"pll_lock_ms\":%.3f,\"button_wake_ms\":%.3f,\"ir_wake_ms\":%.3f,\"ok\":%s}\n",
+           SLEEP_IDLE_MS, sleeps, asleep, pllMs, buttonMs, infraredMs, ok ? "true" : "false");
+
+    // Leave the firmware as it was at power on for the call benchmarks
+    hostEraseFlash();
+    hostPowerOn();
+    setupMorseCode();
+}
+
+#define AMBIENT_LIGHT_LEVEL 128
+#define AMBIENT_LIGHT_MS 6000
+
+// Steady light must look like no signal from the first sample on
+static void benchmarkAmbientLight(void)
+{
+    hostEraseFlash();
+    hostPowerOn();
+    setupMorseCode();
+    hostSetAnalogInput(ANQ1, AMBIENT_LIGHT_LEVEL);
+    enterReceiverMode(LightInput);
+
+    bool marked = false;
+    unsigned long long end = hostGetCycles() + AMBIENT_LIGHT_MS * HOST_CYCLES_PER_MS;
+    while (hostGetCycles() < end)
+    {
+        runMorseCode();
+        hostDelayCycles(200);
+        marked |= LED4;
+    }
+    char text[17];
+    hostGetLcdRow(DISPLAY_TEXT_ROW, text);
+    bool decoded = strspn(text, " ") != strlen(text);
+    unsigned int conflicts = hostGetLcdPinConflicts();
+
+    bool ok = !marked && !decoded && conflicts == 0;
+    failures += !ok;
+    printf("{\"bench\":\"light_ambient\",\"level\":%u,\"ms\":%u,\"marks\":%s,\"text\":\"%s\","
+           "\"lcd_conflicts\":%u,\"ok\":%s}\n",
+           AMBIENT_LIGHT_LEVEL, AMBIENT_LIGHT_MS, marked ? "true" : "false", text, conflicts,
+           ok ? "true" : "false");
+
+    // Leave the firmware as it was at power on for the call benchmarks
+    hostEraseFlash();
+    hostPowerOn();
+    setupMorseCode();
+}
+
+// Light marks and spaces shone on Q1 for the receiver to decode.  Q1 reads lower when lit.
+#define LIGHT_SPACE_LEVEL 200
+#define LIGHT_MARK_LEVEL 40
+#define LIGHT_UNIT_MS 100
+#define LIGHT_WORD "PARIS"
+#define LIGHT_TEXT LIGHT_WORD " " LIGHT_WORD
+
+// Shine text onto Q1 in Morse code, running the main loop meanwhile
+// Shine the elements of a letter onto Q1, each followed by a one unit space
+static void shineLetter(char c, unsigned int unitMs)
+{
+    for (unsigned char code = char_to_code(c); code != MORSE_CODE_END; code >>= 1)
+    {
+        hostSetAnalogInput(ANQ1, LIGHT_MARK_LEVEL);
+        runSleeping((code & 1 ? 3 : 1) * unitMs);
+        hostSetAnalogInput(ANQ1, LIGHT_SPACE_LEVEL);
+        runSleeping(unitMs);
+    }
+}
+
+static void sendLight(const char *text, unsigned int unitMs)
+{
+    for (; *text != EOS; text++)
+    {
+        if (*text == ' ')
+        {
+            runSleeping(4 * unitMs); // With the letter gap before it, a word gap is 7 units
+            continue;
+        }
+        shineLetter(*text, unitMs);
+        runSleeping(2 * unitMs);
+    }
+}
+
+// Copy what the LCD shows on a row into text, which must have room for 17 characters, without
+// the spaces around it
+static void getLcdText(unsigned char row, char *text)
+{
+    char shown[17];
+    hostGetLcdRow(row, shown);
+    unsigned char first = 0, end = LCD_COLUMNS;
+    while (first < end && shown[first] == ' ')
+        first++;
+    while (end > first && shown[end - 1] == ' ')
+        end--;
+    memcpy(text, &shown[first], end - first);
+    text[end - first] = EOS;
+}
+
+static void benchmarkLightReceive(void)
+{
+    hostEraseFlash();
+    hostPowerOn();
+    setupMorseCode();
+    hostSetAnalogInput(ANQ1, LIGHT_SPACE_LEVEL);
+    enterReceiverMode(LightInput);
+    runSleeping(1000);
+
+    // The LCD must keep up with the text while the light input is still being sampled
+    sendLight(LIGHT_WORD " ", LIGHT_UNIT_MS);
+    char firstWord[17];
+    getLcdText(DISPLAY_TEXT_ROW, firstWord);
+
+    // Before the next letter is finished, the status row shows its elements and the speed
+    shineLetter(LIGHT_WORD[0], LIGHT_UNIT_MS);
+    char status[17];
+    hostGetLcdRow(DISPLAY_STATUS_ROW, status);
+    runSleeping(2 * LIGHT_UNIT_MS);
+    sendLight(LIGHT_WORD + 1, LIGHT_UNIT_MS);
+    runSleeping(10 * LIGHT_UNIT_MS);
+    char text[17];
+    getLcdText(DISPLAY_TEXT_ROW, text);
+    unsigned int conflicts = hostGetLcdPinConflicts();
+
+    bool ok = strcmp(firstWord, LIGHT_WORD) == 0 && strcmp(text, LIGHT_TEXT) == 0 && conflicts == 0;
+    failures += !ok;
+    printf("{\"bench\":\"light_receive\",\"unit_ms\":%u,\"sent\":\"%s\",\"first_word_shown\":\"%s\","
+           "\"text\":\"%s\",\"lcd_conflicts\":%u,\"ok\":%s}\n",
+           LIGHT_UNIT_MS, LIGHT_TEXT, firstWord, text, conflicts, ok ? "true" : "false");
+
+    char elements[DISPLAY_MAX_ELEMENTS + 1] = "";
+    for (unsigned char code = char_to_code(LIGHT_WORD[0]), i = 0; code != MORSE_CODE_END; code >>= 1)
+        elements[i++] = code & 1 ? DASH : DOT;
+    unsigned int wpm = WPM_UNIT_LENGTH_MS / LIGHT_UNIT_MS;
+    char expected[17];
+    snprintf(expected, sizeof(expected), "RX  %-6s%3uWPM", elements, wpm);
+    ok = strcmp(status, expected) == 0;
+    failures += !ok;
+    printf("{\"bench\":\"light_display\",\"status\":\"%s\",\"expected\":\"%s\",\"ok\":%s}\n",
+           status, expected, ok ? "true" : "false");
+
+    // Leave the firmware as it was at power on for the call benchmarks
+    hostEraseFlash();
+    hostPowerOn();
+    setupMorseCode();
+}
+
+// The host's monotonic clock, in nanoseconds.  The call benchmarks use it rather than
+// hostGetCycles(), which doesn't move while firmware code runs.
+static double nowNs(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+#define CALL_BATCHES 20
+#define CALLS_PER_BATCH 2000
+
+static void benchmarkCall(const char *name, void (*call)(void))
+{
+    double total = 0, best = 0, worst = 0;
+    for (unsigned int batch = 0; batch < CALL_BATCHES; batch++)
+    {
+        double start = nowNs();
+        for (unsigned int i = 0; i < CALLS_PER_BATCH; i++)
+            call();
+        double ns = (nowNs() - start) / CALLS_PER_BATCH;
+        total += ns;
+        if (batch == 0 || ns < best)
+            best = ns;
+        if (ns > worst)
+            worst = ns;
+    }
+    printf("{\"bench\":\"host_call\",\"function\":\"%s\",\"calls\":%u,\"host_ns_mean\":%.1f,"
+           "\"host_ns_min\":%.1f,\"host_ns_max\":%.1f}\n",
+           name, CALL_BATCHES * CALLS_PER_BATCH, total / CALL_BATCHES, best, worst);
+}
+
+static volatile unsigned int sink;
+
+static void callCalculateNoteReload(void)
+{
+    for (unsigned char note = C; note <= B; note++)
+        sink += calculateNoteReload(note);
+}
+
+static void callPlayNote(void)
+{
+    playNote(A | QuarterNote);
+    stopTone();
+}
+
+static void callMakeSound(void)
+{
+    makeSound(400, 900);
+    stopTone();
+}
+
+static void callLcdPutString(void)
+{
+    // Alternate between two texts on each row so every call changes every cell
+    sink++;
+    lcdPutString(sink & 1, 0, (sink & 2) ? "0123456789ABCDEF" : "FEDCBA9876543210");
+}
+
+static void callTransmitMessage(void)
+{
+    transmitMessage();
+    stopTransmitting();
+}
+
+// Tone interrupts, each toggling the beeper for one half-cycle of a constant or shaped tone or
+// working out one sample of a chord
+static void callHandleToneInterrupt(void)
+{
+    handleToneInterrupt();
+}
+
+int main(void)
+{
+    hostPowerOn();
+    setupMorseCode();
+    hostOutputChanged = &outputChanged;
+
+    benchmarkPitch();
+    benchmarkMorse();
+    benchmarkInfraredLoopback();
+    benchmarkTempo();
+    benchmarkNoteLength();
+    benchmarkLcd();
+    benchmarkSerial();
+    benchmarkStorage();
+    benchmarkMessageRoom();
+    benchmarkSleep();
+    benchmarkAmbientLight();
+    benchmarkLightReceive();
+
+    benchmarkCall("calculateNoteReload", &callCalculateNoteReload);
+    benchmarkCall("playNote", &callPlayNote);
+    benchmarkCall("makeSound", &callMakeSound);
+    benchmarkCall("transmitMessage", &callTransmitMessage);
+    benchmarkCall("lcdPutString", &callLcdPutString);
+    startMorseCodeTone();
+    benchmarkCall("handleToneInterrupt", &callHandleToneInterrupt);
+    makeShapedSound(0xFFFF, MORSE_CODE_DOT_PERIOD / PERIOD_SCALE, &valleyEnvelope);
+    benchmarkCall("handleToneInterrupt (shaped)", &callHandleToneInterrupt);
+    playChord(cMajor);
+    benchmarkCall("handleToneInterrupt (chord)", &callHandleToneInterrupt);
+    stopTone();
+
+    printf("{\"bench\":\"summary\",\"failures\":%u}\n", failures);
+    return 0;
+}
@@ -0,0 +1,678 @@
+/*==============================================================================
+ File: hostHardware.c
+
+ Register storage and peripheral models behind the host xc.h. See
+ hostHardware.h for an overview.
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "xc.h"
+#include "hostHardware.h"
+
+volatile unsigned char PORTA, PORTB, PORTC;
+volatile unsigned char LATA, LATB, LATC;
+volatile unsigned char TRISA, TRISB, TRISC;
+volatile unsigned char ANSELA, ANSELB, ANSELC, WPUA, WPUB;
+volatile unsigned char OPTION_REG, INTCON, PIE1, PIR1, PIE2, PIR2;
+volatile unsigned char IOCAP, IOCAN, IOCAF, IOCBP, IOCBN, IOCBF;
+volatile unsigned char TMR0, T1CON, TMR1L, TMR1H;
+volatile unsigned char T2CON, TMR2, PR2, PWM1CON, PWM1DCL, PWM1DCH;
+volatile unsigned char ADCON0, ADCON1, ADCON2, ADRESL, ADRESH;
+volatile unsigned char OSCCON, OSCSTAT, ACTCON;
+volatile unsigned char FVRCON, CM2CON0, CM2CON1;
+volatile unsigned char PMADRL, PMADRH, PMDATL, PMDATH, PMCON1, PMCON2;
+volatile unsigned char UCON, UCFG, UIR, UIE, UEIR, USTAT, UADDR, UEP0, UEP1, UEP2;
+
+// The firmware's interrupt handler
+void isr(void);
+
+FILE *hostTrace = NULL;
+void (*hostOutputChanged)(unsigned char output, bool on) = NULL;
+
+// The internals are static so they can't clash with the firmware's global names
+static unsigned long long cycle = 0;
+
+// Instruction cycles counted towards the next timer increment
+static unsigned int timer0Prescale = 0;
+static unsigned int timer1Prescale = 0;
+
+// A write to TMR0 clears its prescaler and holds it for 2 cycles.  The firmware takes no time, so
+// the tick's write comes straight after the overflow, where on the PIC the prescaler has counted
+// the interrupt's latency and the handler's first instructions by then (14 cycles, as counted in
+// scheduler.h).  Those are lost too, so Timer0 is held for them as well.  Writes are spotted by
+// TMR0 no longer holding the count the model left in it, so writing the same count isn't seen.
+#define HOST_TMR0_WRITE_INHIBIT_CYCLES (2 + 14)
+static unsigned char timer0Counted = 0;
+static unsigned int timer0Inhibit = 0;
+
+// The level each ADC channel converts to, indexed by the CHS bits
+static unsigned char analogInputs[32];
+
+// The pins the hardware drives: buttons SW1-SW5 (1 = pressed) and the IR demodulator
+static unsigned char buttonsDown = 0;
+static bool infraredCarrier = false;
+
+// Comparator C2's output, which only changes with the IR demodulator's pin
+static bool comparatorOutput = false;
+
+// Sleep: whether the PIC is asleep, the latest cycle it sleeps until, and how much it has slept
+static bool asleep = false;
+static unsigned long long sleepLimit = 0;
+static unsigned int sleeps = 0;
+static unsigned long long cyclesAsleep = 0;
+
+// The outputs as of the last check, and the tone currently being played on the beeper
+static unsigned char tracedLatA = 0;
+static unsigned char tracedLatC = 0;
+static double tracedCarrierHz = 0;
+
+// The HD44780 LCD on H1-H6 (see lcd.h), written 4 bits at a time as EN falls.  It starts in
+// 8-bit mode, where each write is a whole command with the low 4 bits unconnected.
+static bool lcdEnable = false;
+static bool lcdFourBit = false;
+static bool lcdHaveHighNibble = false;
+static unsigned char lcdHighNibble;
+static unsigned char lcdAddress;
+static char lcdMemory[0x80];
+static unsigned long long lcdReadyAt;
+static unsigned int lcdTimingErrors;
+static unsigned int lcdPinConflicts;
+// Whether RC3 (Q1's pin, D5) has been driven since power on, and when it last was
+static bool q1Driven;
+static unsigned long long q1DrivenAt;
+static char tracedLcd[2][16];
+// The high-endurance flash and its write latches, one row of 32 words.  The flash is only set
+// to erased once, so it keeps its contents through hostPowerOn().
+#define FLASH_ROW_WORDS 32
+#define FLASH_ERASED 0x3FFF
+static unsigned int flashMemory[HOST_HEF_WORDS];
+static unsigned int flashLatches[FLASH_ROW_WORDS];
+static bool flashLatchLoaded[FLASH_ROW_WORDS];
+static bool flashInitialised = false;
+static unsigned int flashErases, flashWrites, flashErrors;
+static unsigned long long toneStart;
+static unsigned long long toneLastEdge;
+static unsigned long toneEdges = 0;
+
+static void trace(unsigned long long at, const char *event)
+{
+    if (hostTrace != NULL)
+        fprintf(hostTrace, "%.3f %s\n", (double)at / HOST_CYCLES_PER_MS, event);
+}
+
+static void endTone(void)
+{
+    if (toneEdges >= 2)
+    {
+        char event[48];
+        double seconds = (double)(toneLastEdge - toneStart) / HOST_CYCLES_PER_SECOND;
+        double halfCycles = toneEdges - 1;
+        snprintf(event, sizeof(event), "TONE %.1f %.1f", halfCycles / 2 / seconds, seconds * 1000);
+        trace(toneStart, event);
+    }
+    toneEdges = 0;
+}
+
+void hostEraseFlash(void)
+{
+    for (unsigned int i = 0; i < HOST_HEF_WORDS; i++)
+        flashMemory[i] = FLASH_ERASED;
+    for (unsigned int i = 0; i < FLASH_ROW_WORDS; i++)
+    {
+        flashLatches[i] = FLASH_ERASED;
+        flashLatchLoaded[i] = false;
+    }
+    flashInitialised = true;
+}
+
+unsigned int hostGetFlashErases(void)
+{
+    return flashErases;
+}
+
+unsigned int hostGetFlashWrites(void)
+{
+    return flashWrites;
+}
+
+unsigned int hostGetFlashErrors(void)
+{
+    return flashErrors;
+}
+
+double hostInfraredCarrierHz(void)
+{
+    // PWM1 drives RC5 while it is enabled with its output on, and Timer2 is clocking it.  Timer2
+    // isn't modelled beyond that: the firmware doesn't use its interrupt.
+    if (!PWM1CONbits.PWM1EN || !PWM1CONbits.PWM1OE || !T2CONbits.TMR2ON || TRISCbits.TRISC5)
+        return 0;
+    static const unsigned char prescalers[] = {1, 4, 16, 64};
+    return (double)HOST_CYCLES_PER_SECOND / (prescalers[T2CON & 0b00000011] * (PR2 + 1u));
+}
+
+// Carry out a command or character written to the LCD
+static void executeLcd(bool rs, unsigned char value)
+{
+    if (cycle < lcdReadyAt)
+        lcdTimingErrors++;
+    lcdReadyAt = cycle + HOST_LCD_COMMAND_CYCLES;
+    if (rs)
+    {
+        lcdMemory[lcdAddress] = value;
+        lcdAddress = (lcdAddress + 1) & 0x7F;
+    }
+    else if (value & 0x80)
+        lcdAddress = value & 0x7F;
+    else if (value == 0x01)
+    {
+        for (unsigned char i = 0; i < sizeof(lcdMemory); i++)
+            lcdMemory[i] = ' ';
+        lcdAddress = 0;
+        lcdReadyAt = cycle + HOST_LCD_CLEAR_CYCLES;
+    }
+    else if ((value & 0xE0) == 0x20)
+        lcdFourBit = !(value & 0x10); // Function set
+}
+
+static void clockLcd(void)
+{
+    if (!TRISCbits.TRISC3)
+    {
+        q1Driven = true;
+        q1DrivenAt = cycle;
+    }
+
+    // EN only reaches the LCD while RC1 is an output
+    bool enable = LATCbits.LATC1 && !TRISCbits.TRISC1;
+    if (lcdEnable && !enable)
+    {
+        // D4 (RC2) driven while the IR demodulator is pulling it low
+        if (!TRISCbits.TRISC2 && infraredCarrier)
+            lcdPinConflicts++;
+
+        unsigned char nibble = (LATC >> 2) & 0x0F;
+        if (!lcdFourBit)
+            executeLcd(LATCbits.LATC0, nibble << 4);
+        else if (!lcdHaveHighNibble)
+        {
+            lcdHighNibble = nibble;
+            lcdHaveHighNibble = true;
+        }
+        else
+        {
+            lcdHaveHighNibble = false;
+            executeLcd(LATCbits.LATC0, lcdHighNibble << 4 | nibble);
+        }
+    }
+    lcdEnable = enable;
+}
+
+void hostGetLcdRow(unsigned char row, char *text)
+{
+    for (unsigned char column = 0; column < 16; column++)
+        text[column] = lcdMemory[(row ? 0x40 : 0) + column];
+    text[16] = '\0';
+}
+
+unsigned int hostGetLcdTimingErrors(void)
+{
+    return lcdTimingErrors;
+}
+
+unsigned int hostGetLcdPinConflicts(void)
+{
+    return lcdPinConflicts;
+}
+
+// Trace any output that changed since the last check
+static void checkOutputs(void)
+{
+    clockLcd();
+    for (unsigned char row = 0; row < 2; row++)
+    {
+        char text[17];
+        hostGetLcdRow(row, text);
+        if (memcmp(text, tracedLcd[row], 16) != 0)
+        {
+            char event[32];
+            snprintf(event, sizeof(event), "LCD%u \"%s\"", row + 1, text);
+            trace(cycle, event);
+            memcpy(tracedLcd[row], text, 16);
+        }
+    }
+
+    // While the LCD driver has borrowed H3-H6 (RC2, the IR demodulator's pin, is an output) LED3,
+    // LED4 and the carrier's pin are carrying LCD data, so wait until it has put them back
+    if (!TRISCbits.TRISC2)
+        return;
+
+    if (toneEdges > 0 && cycle - toneLastEdge > HOST_TONE_GAP_MS * HOST_CYCLES_PER_MS)
+        endTone();
+    if ((LATA ^ tracedLatA) & 0b00010000)
+    {
+        if (toneEdges == 0)
+            toneStart = cycle;
+        toneLastEdge = cycle;
+        toneEdges++;
+        if (hostOutputChanged != NULL)
+            hostOutputChanged(HOST_BEEPER, LATA & 0b00010000);
+    }
+    tracedLatA = LATA;
+
+    // LED3-LED6 are on RC4-RC7
+    for (unsigned char led = 3; led <= 6; led++)
+    {
+        unsigned char pin = 1 << (led + 1);
+        if ((LATC ^ tracedLatC) & pin)
+        {
+            char event[16];
+            snprintf(event, sizeof(event), "LED%u %u", led, (LATC & pin) ? 1 : 0);
+            trace(cycle, event);
+            if (hostOutputChanged != NULL)
+                hostOutputChanged(led, LATC & pin);
+        }
+    }
+    tracedLatC = LATC;
+
+    double carrierHz = hostInfraredCarrierHz();
+    if (carrierHz != tracedCarrierHz)
+    {
+        char event[24];
+        snprintf(event, sizeof(event), "IR %.1f", carrierHz);
+        trace(cycle, event);
+        if (hostOutputChanged != NULL && (carrierHz == 0) != (tracedCarrierHz == 0))
+            hostOutputChanged(HOST_IR_CARRIER, carrierHz != 0);
+        tracedCarrierHz = carrierHz;
+    }
+}
+
+void hostFlushTrace(void)
+{
+    checkOutputs();
+    endTone();
+}
+
+// Comparator C2's output is high while RC2 (C12IN2-) is below the fixed voltage reference, and
+// C2IF is set on the enabled edges.  Only that pair of inputs is modelled.
+static void updateComparator(void)
+{
+    bool output = CM2CON0bits.C2ON && FVRCONbits.FVREN && (CM2CON1 & 0b00110011) == 0b00100010 &&
+                  !PORTCbits.RC2;
+    if (output != comparatorOutput && (output ? CM2CON1bits.C2INTP : CM2CON1bits.C2INTN))
+        PIR2bits.C2IF = 1;
+    comparatorOutput = output;
+    CM2CON0bits.C2OUT = output;
+}
+
+// Drive the input pins from the button and IR state
+static void updateInputPins(void)
+{
+    // The buttons are active low with pull-ups: SW1 is RA3 and SW2-SW5 are RB4-RB7
+    unsigned char portA = (PORTA & ~0b00001000) | ((buttonsDown & 0b00000010) ? 0 : 0b00001000);
+    unsigned char portB = (PORTB & ~0b11110000) | (~buttonsDown << 2 & 0b11110000);
+    // Interrupt-on-change flags are set for the enabled edges
+    IOCAF |= ((portA & ~PORTA) & IOCAP) | ((~portA & PORTA) & IOCAN);
+    IOCBF |= ((portB & ~PORTB) & IOCBP) | ((~portB & PORTB) & IOCBN);
+    PORTA = portA;
+    PORTB = portB;
+
+    // The IR demodulator's output (RC2) is low while it receives a carrier
+    PORTCbits.RC2 = !infraredCarrier;
+    updateComparator();
+}
+
+void hostPowerOn(void)
+{
+    PORTA = PORTB = PORTC = 0;
+    LATA = LATB = LATC = 0;
+    TRISA = TRISB = TRISC = 0xFF;
+    ANSELA = ANSELB = ANSELC = 0xFF;
+    WPUA = WPUB = 0xFF;
+    OPTION_REG = 0xFF;
+    INTCON = PIE1 = PIR1 = PIE2 = PIR2 = 0;
+    IOCAP = IOCAN = IOCAF = IOCBP = IOCBN = IOCBF = 0;
+    TMR0 = T1CON = TMR1L = TMR1H = 0;
+    T2CON = TMR2 = PWM1CON = PWM1DCL = PWM1DCH = 0;
+    PR2 = 0xFF;
+    ADCON0 = ADCON1 = ADCON2 = ADRESL = ADRESH = 0;
+    OSCCON = ACTCON = 0;
+    OSCSTAT = 0;
+    PLLRDY = 1; // The PLL is simulated as locked straight away
+    FVRCON = CM2CON0 = CM2CON1 = 0;
+    PMADRL = PMADRH = PMDATL = PMDATH = PMCON1 = PMCON2 = 0;
+    UCON = UCFG = UIR = UIE = UEIR = USTAT = UADDR = 0;
+    UEP0 = UEP1 = UEP2 = 0;
+    if (!flashInitialised)
+        hostEraseFlash();
+
+    cycle = 0;
+    timer0Prescale = 0;
+    timer1Prescale = 0;
+    timer0Counted = 0;
+    timer0Inhibit = 0;
+    tracedLatA = 0;
+    tracedLatC = 0;
+    tracedCarrierHz = 0;
+    toneEdges = 0;
+    comparatorOutput = false;
+    asleep = false;
+    sleepLimit = 0;
+    sleeps = 0;
+    cyclesAsleep = 0;
+    lcdEnable = false;
+    lcdFourBit = false;
+    lcdHaveHighNibble = false;
+    lcdAddress = 0;
+    lcdReadyAt = 0;
+    lcdTimingErrors = 0;
+    lcdPinConflicts = 0;
+    q1Driven = false;
+    for (unsigned char i = 0; i < sizeof(lcdMemory); i++)
+        lcdMemory[i] = ' ';
+    for (unsigned char row = 0; row < 2; row++)
+        for (unsigned char column = 0; column < 16; column++)
+            tracedLcd[row][column] = ' ';
+    updateInputPins();
+    IOCAF = IOCBF = 0;
+}
+
+unsigned long long hostGetCycles(void)
+{
+    return cycle;
+}
+
+void hostSetButton(unsigned char button, bool pressed)
+{
+    if (pressed)
+        buttonsDown |= 1 << button;
+    else
+        buttonsDown &= ~(1 << button);
+    updateInputPins();
+}
+
+void hostSetInfrared(bool carrier)
+{
+    infraredCarrier = carrier;
+    updateInputPins();
+}
+
+void hostSetAnalogInput(unsigned char channel, unsigned char level)
+{
+    analogInputs[(channel >> 2) & 0b00011111] = level;
+}
+
+void hostReset(void)
+{
+    hostFlushTrace();
+    trace(cycle, "RESET");
+    exit(0);
+}
+
+// The number of instruction cycles per count of Timer0, or 0 if it isn't counting them
+static unsigned int timer0Divider(void)
+{
+    if (OPTION_REGbits.TMR0CS)
+        return 0;
+    return OPTION_REGbits.PSA ? 1 : 2u << (OPTION_REG & 0b00000111);
+}
+
+// The number of instruction cycles per count of Timer1, or 0 if it is stopped
+static unsigned int timer1Divider(void)
+{
+    if (!T1CONbits.TMR1ON || (T1CON & 0b11000000) != 0)
+        return 0;
+    return 1u << ((T1CON >> 4) & 0b00000011);
+}
+
+static void checkTimer0Write(void)
+{
+    if (TMR0 == timer0Counted)
+        return;
+    timer0Prescale = 0;
+    timer0Inhibit = HOST_TMR0_WRITE_INHIBIT_CYCLES;
+    timer0Counted = TMR0;
+}
+
+// Conversions complete in the step they start in; the conversion time isn't modelled
+static void convert(void)
+{
+    // Q1 on AN7 can't be read while its pin is driven, or until the pin has settled afterwards
+    if (((ADCON0 >> 2) & 0b00011111) == 7 &&
+        (!TRISCbits.TRISC3 || (q1Driven && cycle - q1DrivenAt < HOST_Q1_SETTLE_CYCLES)))
+        lcdPinConflicts++;
+    ADRESH = analogInputs[(ADCON0 >> 2) & 0b00011111];
+    ADRESL = 0;
+    GO = 0;
+    PIR1bits.ADIF = 1;
+}
+
+// Advance the peripherals by a number of cycles that takes each timer at most up to its overflow
+static void stepPeripherals(unsigned long long cycles)
+{
+    unsigned int divider = timer0Divider();
+    checkTimer0Write();
+    if (divider)
+    {
+        unsigned long long counting = cycles;
+        unsigned int held = counting < timer0Inhibit ? (unsigned int)counting : timer0Inhibit;
+        timer0Inhibit -= held;
+        counting -= held;
+        unsigned long long counts = (timer0Prescale + counting) / divider;
+        timer0Prescale = (timer0Prescale + counting) % divider;
+        if (counts >= 256u - TMR0)
+        {
+            INTCONbits.TMR0IF = 1;
+            // ADCON2's TRIGSEL bits can start a conversion on every Timer0 overflow
+            if (ADON && (ADCON2 & 0b11110000) == 0b00110000)
+                GO = 1;
+        }
+        TMR0 = timer0Counted = (unsigned char)(TMR0 + counts);
+    }
+
+    divider = timer1Divider();
+    if (divider)
+    {
+        unsigned int count = TMR1H << 8 | TMR1L;
+        unsigned long long counts = (timer1Prescale + cycles) / divider;
+        timer1Prescale = (timer1Prescale + cycles) % divider;
+        if (counts >= 65536u - count)
+            PIR1bits.TMR1IF = 1;
+        count = (unsigned int)(count + counts);
+        TMR1H = count >> 8;
+        TMR1L = count & 0xFF;
+    }
+
+    if (ADON && GO)
+        convert();
+
+    // The reference's settling time isn't modelled
+    FVRCONbits.FVRRDY = FVRCONbits.FVREN;
+    updateComparator();
+}
+
+// The number of cycles until the next timer overflow, or the given limit if that is sooner
+static unsigned long long cyclesToNextEvent(unsigned long long limit)
+{
+    unsigned int divider = timer0Divider();
+    checkTimer0Write();
+    if (divider)
+    {
+        unsigned long long due = timer0Inhibit + (256ull - TMR0) * divider - timer0Prescale;
+        if (due < limit)
+            limit = due;
+    }
+    divider = timer1Divider();
+    if (divider)
+    {
+        unsigned long long due = (65536ull - (TMR1H << 8 | TMR1L)) * divider - timer1Prescale;
+        if (due < limit)
+            limit = due;
+    }
+    return limit > 0 ? limit : 1;
+}
+
+// Returns true if an enabled interrupt flag is set, which also wakes the PIC from sleep
+static bool interruptFlagged(void)
+{
+    // IOCIF is read-only: it is set while any interrupt-on-change flag is
+    INTCONbits.IOCIF = (IOCAF | IOCBF) != 0;
+    return (INTCONbits.TMR0IE && INTCONbits.TMR0IF) || (INTCONbits.IOCIE && INTCONbits.IOCIF) ||
+           (INTCONbits.PEIE && ((PIE1 & PIR1) | (PIE2 & PIR2)) != 0);
+}
+
+static bool interruptPending(void)
+{
+    bool flagged = interruptFlagged();
+    return flagged && INTCONbits.GIE;
+}
+
+static void dispatchInterrupts(void)
+{
+    unsigned int calls = 0;
+    while (interruptPending())
+    {
+        if (++calls > 1000)
+        {
+            fprintf(stderr, "host: an interrupt flag is never cleared (INTCON=%02X PIR1=%02X PIR2=%02X)\n", INTCON, PIR1, PIR2);
+            exit(1);
+        }
+        // The hardware clears GIE while the handler runs and RETFIE sets it again
+        INTCONbits.GIE = 0;
+        isr();
+        INTCONbits.GIE = 1;
+        checkOutputs();
+    }
+}
+
+// The CPU stops while flash is erased or written, so interrupts wait until it is done, but the
+// peripherals carry on
+static void stallCpu(unsigned long long cycles)
+{
+    while (cycles > 0)
+    {
+        unsigned long long step = cyclesToNextEvent(cycles);
+        stepPeripherals(step);
+        cycle += step;
+        cycles -= step;
+    }
+}
+
+// Carry out a flash read, or an erase or write once the unlock sequence has set WR
+static void runFlashOperation(void)
+{
+    unsigned int address = (PMADRH << 8 | PMADRL) & 0x7FFF;
+    bool inHef = !PMCON1bits.CFGS && address >= HOST_HEF_ADDRESS && address < HOST_HEF_ADDRESS + HOST_HEF_WORDS;
+    unsigned int *word = inHef ? &flashMemory[address - HOST_HEF_ADDRESS] : NULL;
+    char event[32];
+
+    if (PMCON1bits.RD)
+    {
+        PMCON1bits.RD = 0;
+        unsigned int data = word != NULL ? *word : FLASH_ERASED;
+        PMDATH = data >> 8;
+        PMDATL = data & 0xFF;
+    }
+    if (!PMCON1bits.WR)
+        return;
+
+    // The unlock sequence writes 0x55 then 0xAA to PMCON2; only the last value can be checked
+    PMCON1bits.WR = 0;
+    bool unlocked = PMCON1bits.WREN && PMCON2 == 0xAA;
+    PMCON2 = 0;
+    if (!unlocked || word == NULL)
+    {
+        flashErrors++;
+        return;
+    }
+    unsigned int row = (address - HOST_HEF_ADDRESS) & ~(FLASH_ROW_WORDS - 1);
+    if (PMCON1bits.FREE)
+    {
+        for (unsigned int i = 0; i < FLASH_ROW_WORDS; i++)
+            flashMemory[row + i] = FLASH_ERASED;
+        flashErases++;
+        snprintf(event, sizeof(event), "FLASH erase %04X", HOST_HEF_ADDRESS + row);
+        trace(cycle, event);
+        stallCpu(HOST_FLASH_ERASE_CYCLES);
+        return;
+    }
+
+    // Programming can only clear bits, so words left erased in the latches change nothing.  A
+    // word that is loaded is programmed, which must only happen once between erases.
+    flashLatches[address % FLASH_ROW_WORDS] = (PMDATH << 8 | PMDATL) & FLASH_ERASED;
+    flashLatchLoaded[address % FLASH_ROW_WORDS] = true;
+    if (PMCON1bits.LWLO)
+        return;
+    for (unsigned int i = 0; i < FLASH_ROW_WORDS; i++)
+    {
+        if (flashLatchLoaded[i] && flashMemory[row + i] != FLASH_ERASED)
+            flashErrors++;
+        flashMemory[row + i] &= flashLatches[i];
+        flashLatches[i] = FLASH_ERASED;
+        flashLatchLoaded[i] = false;
+    }
+    flashWrites++;
+    snprintf(event, sizeof(event), "FLASH write %04X", HOST_HEF_ADDRESS + row);
+    trace(cycle, event);
+    stallCpu(HOST_FLASH_WRITE_CYCLES);
+}
+
+void hostDelayCycles(unsigned long long cycles)
+{
+    if (PMCON1bits.RD || PMCON1bits.WR)
+        runFlashOperation();
+    checkOutputs();
+    dispatchInterrupts();
+    while (cycles > 0)
+    {
+        unsigned long long step = cyclesToNextEvent(cycles);
+        stepPeripherals(step);
+        cycle += step;
+        cycles -= step;
+        dispatchInterrupts();
+    }
+}
+
+void hostSetSleepLimit(unsigned long long cycles)
+{
+    sleepLimit = cycles;
+}
+
+unsigned int hostGetSleeps(void)
+{
+    return sleeps;
+}
+
+unsigned long long hostGetCyclesAsleep(void)
+{
+    return cyclesAsleep;
+}
+
+// The oscillator stops while the PIC sleeps, and with it the timers, so the clock jumps to
+// whatever wakes it.  Only the host's inputs can, and they don't change during a sleep, so one
+// that isn't woken straight away lasts until the sleep limit.
+void hostSleep(void)
+{
+    checkOutputs();
+    if (!asleep)
+    {
+        asleep = true;
+        sleeps++;
+        trace(cycle, "SLEEP");
+    }
+    if (!interruptFlagged() && cycle < sleepLimit)
+    {
+        cyclesAsleep += sleepLimit - cycle;
+        cycle = sleepLimit;
+    }
+    if (interruptFlagged())
+    {
+        asleep = false;
+        trace(cycle, "WAKE");
+        // PLLRDY is simulated as always set, so the firmware's wait for it is charged here
+        cycle += HOST_PLL_LOCK_CYCLES;
+    }
+}
@@ -0,0 +1,167 @@
+/*==============================================================================
+ File: hostHardware.h
+
+ Simulated UBMP4 hardware for building and running the firmware on Linux.
+ The registers declared in the host xc.h are backed by models of the parts
+ of the PIC16F1459 the firmware uses: Timer0, Timer1, interrupt-on-change,
+ the ADC, PWM1's carrier, comparator C2, the interrupt controller, sleep and
+ the high-endurance flash rows, and of the HD44780 LCD on H1-H6. Time is counted in instruction cycles
+ on a virtual clock that only moves when the firmware waits (see xc.h) or the
+ caller runs it with hostDelayCycles().
+
+ Output changes are written to a trace, one line per event:
+
+   <ms> LED<n> <0|1>              an LED turned off or on
+   <ms> TONE <Hz> <ms>            a tone, reported with its start time once it ends
+   <ms> IR <Hz>                   the IR LED's PWM carrier started, or stopped (0 Hz)
+   <ms> LCD<n> "<text>"           row 1 or 2 of the LCD changed
+   <ms> SERIAL "<text>"           text sent to the computer on the USB serial port
+   <ms> FLASH <erase|write> <addr> a flash row was erased or written, stopping the CPU
+   <ms> SLEEP                     the PIC went to sleep
+   <ms> WAKE                      an interrupt flag woke it (the PLL locks after this)
+   <ms> RESET                     the firmware reset the PIC
+==============================================================================*/
+
+#ifndef HOST_HARDWARE_H
+#define HOST_HARDWARE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// The simulated PIC runs at 48 MHz, so the instruction clock (Fosc/4) is 12 MHz
+#define HOST_CYCLES_PER_SECOND 12000000ULL
+#define HOST_CYCLES_PER_MS (HOST_CYCLES_PER_SECOND / 1000)
+
+// A tone is considered over when the beeper hasn't toggled for this long
+#define HOST_TONE_GAP_MS 25
+
+// How long the LCD takes to carry out a command (37 us), or a clear (1.52 ms)
+#define HOST_LCD_COMMAND_CYCLES 444
+#define HOST_LCD_CLEAR_CYCLES 18240
+
+// How long Q1's pin takes to get back to Q1's level after being driven (100 us)
+#define HOST_Q1_SETTLE_CYCLES 1200
+
+// How long the CPU stops while a flash row is erased or written (2 ms each)
+#define HOST_FLASH_ERASE_CYCLES 24000
+#define HOST_FLASH_WRITE_CYCLES 24000
+
+// How long the PLL takes to lock again after the PIC wakes (at most 2 ms), while the timers
+// stay stopped
+#define HOST_PLL_LOCK_CYCLES 24000
+
+// The flash that is modelled: the high-endurance rows at the end of program memory.  Other
+// addresses read as erased and can't be written.
+#define HOST_HEF_ADDRESS 0x1F80
+#define HOST_HEF_WORDS 128
+
+// Where trace lines are written.  Set to NULL to turn the trace off.
+extern FILE *hostTrace;
+
+// The outputs reported to hostOutputChanged: the beeper, LED3-LED6 by number, or the IR carrier
+// (numbered after LED D2, the IR LED)
+#define HOST_BEEPER 0
+#define HOST_IR_CARRIER 2
+
+// If set, called whenever the beeper toggles, an LED changes or the IR carrier starts or stops,
+// at hostGetCycles()
+extern void (*hostOutputChanged)(unsigned char output, bool on);
+
+/**
+ * Put the registers into their power-on state and restart the virtual clock.  Call before
+ * the firmware's set-up code.  The flash keeps what was written to it, as on the PIC.
+ */
+void hostPowerOn(void);
+
+/**
+ * Returns the number of instruction cycles since hostPowerOn()
+ */
+unsigned long long hostGetCycles(void);
+
+/**
+ * Press (true) or release (false) SW1-SW5
+ */
+void hostSetButton(unsigned char button, bool pressed);
+
+/**
+ * Set whether the IR demodulator is receiving a carrier
+ */
+void hostSetInfrared(bool carrier);
+
+/**
+ * Returns the frequency of the carrier PWM1 is sending out of the IR LED, or 0 when it is off
+ */
+double hostInfraredCarrierHz(void);
+
+/**
+ * Set the 8-bit level an ADC channel converts to.  The channel is one of the channel
+ * constants in UBMP4.h, e.g. ANQ1.
+ */
+void hostSetAnalogInput(unsigned char channel, unsigned char level);
+
+/**
+ * Copy what the LCD shows on a row (0 or 1) into text, which must have room for 17 characters
+ */
+void hostGetLcdRow(unsigned char row, char *text);
+
+/**
+ * Returns the number of commands and characters written to the LCD before it was ready for them
+ */
+unsigned int hostGetLcdTimingErrors(void);
+
+/**
+ * Returns the number of nibbles written to the LCD while D4 was driven against the IR demodulator
+ * receiving a carrier, plus the number of conversions of the light sensor while D5 was driven or
+ * less than HOST_Q1_SETTLE_CYCLES after it was
+ */
+unsigned int hostGetLcdPinConflicts(void);
+
+/**
+ * Queue text to come in on the USB serial port, as if typed on the computer
+ */
+void hostSerialInput(const char *text);
+
+/**
+ * Carry the USB serial port's text to and from a new pseudo-terminal as well, printing its name
+ * on standard error.  Returns false if one couldn't be opened.
+ */
+bool hostOpenSerialPty(void);
+
+/**
+ * Erase all of the flash, as when the firmware is first programmed
+ */
+void hostEraseFlash(void);
+
+/**
+ * Returns the number of flash rows erased and written, and the number of flash operations the
+ * firmware got wrong (without the unlock sequence or WREN, outside the modelled flash, or
+ * programming a word again without erasing it)
+ */
+unsigned int hostGetFlashErases(void);
+unsigned int hostGetFlashWrites(void);
+unsigned int hostGetFlashErrors(void);
+
+/**
+ * Set the latest cycle that a sleep lasts until when nothing wakes the PIC: the end of the time
+ * the firmware is being run for.  The firmware then carries on as if something had woken it,
+ * and normally goes straight back to sleep, which isn't traced again.  Sleeps don't last at
+ * all until this is set.
+ */
+void hostSetSleepLimit(unsigned long long cycles);
+
+/**
+ * Returns the number of times the PIC went to sleep, and the instruction cycles it spent asleep
+ */
+unsigned int hostGetSleeps(void);
+unsigned long long hostGetCyclesAsleep(void);
+
+/**
+ * Report any tone still in progress
+ */
+void hostFlushTrace(void);
+
+// The firmware's entry points, in morseCode.c
+void setupMorseCode(void);
+void runMorseCode(void);
+
+#endif
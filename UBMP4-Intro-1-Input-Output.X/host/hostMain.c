@@ -0,0 +1,150 @@
+/*==============================================================================
+ File: hostMain.c
+
+ Runs the firmware on Linux against the simulated hardware, driven by a script
+ read from the file named on the command line (or standard input). Each line
+ is one command:
+
+   wait <ms>             run the firmware for a number of milliseconds
+   press <n>             press SWn (1-5)
+   release <n>           release SWn
+   tap <n> [ms]          press SWn, run for ms (default 50), and release it
+   ir <0|1>              stop or start the IR carrier
+   light <level>         set the phototransistor's ADC level (0-255)
+   serial <text>         type a line of text into the USB serial port
+   # ...                 a comment
+
+ The trace of LEDs and tones described in hostHardware.h is written to
+ standard output. Pressing SW1 resets the PIC, which ends the run.
+
+ With -p the USB serial port is also connected to a pseudo-terminal, and once
+ the script has run the firmware carries on in real time until interrupted,
+ so a terminal program can type messages to the sender and read what the
+ receiver decodes.
+==============================================================================*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "xc.h"
+#include "hostHardware.h"
+#include "../UBMP4.h"
+
+// The simulated cost of one pass of the firmware's main loop
+#define MAIN_LOOP_CYCLES 200
+
+#define DEFAULT_TAP_MS 50
+
+static void runFor(unsigned long ms)
+{
+    unsigned long long end = hostGetCycles() + ms * HOST_CYCLES_PER_MS;
+    hostSetSleepLimit(end);
+    while (hostGetCycles() < end)
+    {
+        runMorseCode();
+        hostDelayCycles(MAIN_LOOP_CYCLES);
+    }
+}
+
+static bool runCommand(const char *line)
+{
+    char command[16];
+    long a = 0, b = DEFAULT_TAP_MS;
+    int n = sscanf(line, "%15s %ld %ld", command, &a, &b);
+    if (n < 1 || command[0] == '#')
+        return true;
+
+    if (strcmp(command, "wait") == 0 && n >= 2)
+        runFor(a);
+    else if (strcmp(command, "press") == 0 && n >= 2)
+        hostSetButton(a, true);
+    else if (strcmp(command, "release") == 0 && n >= 2)
+        hostSetButton(a, false);
+    else if (strcmp(command, "tap") == 0 && n >= 2)
+    {
+        hostSetButton(a, true);
+        runFor(b);
+        hostSetButton(a, false);
+    }
+    else if (strcmp(command, "ir") == 0 && n >= 2)
+        hostSetInfrared(a != 0);
+    else if (strcmp(command, "light") == 0 && n >= 2)
+        hostSetAnalogInput(ANQ1, a);
+    else if (strcmp(command, "serial") == 0)
+    {
+        // The rest of the line, ended with the CR a terminal sends for Enter
+        const char *text = strstr(line, "serial") + strlen("serial");
+        text += strspn(text, " \t");
+        char typed[128];
+        snprintf(typed, sizeof(typed), "%.*s\r", (int)strcspn(text, "\r\n"), text);
+        hostSerialInput(typed);
+    }
+    else
+        return false;
+    return true;
+}
+
+// Run the firmware a millisecond at a time, keeping pace with the real clock
+static void runInRealTime(void)
+{
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unsigned long long startCycles = hostGetCycles();
+    while (true)
+    {
+        runFor(1);
+        fflush(stdout);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double elapsed = (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1e9;
+        double simulated = (double)(hostGetCycles() - startCycles) / HOST_CYCLES_PER_SECOND;
+        if (simulated > elapsed)
+        {
+            struct timespec pause = {0, (long)((simulated - elapsed) * 1e9)};
+            nanosleep(&pause, NULL);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool realTime = argc > 1 && strcmp(argv[1], "-p") == 0;
+    if (realTime)
+    {
+        argc--;
+        argv++;
+    }
+
+    FILE *script = stdin;
+    if (argc > 1 && (script = fopen(argv[1], "r")) == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    hostTrace = stdout;
+    hostPowerOn();
+    setupMorseCode();
+    if (realTime && !hostOpenSerialPty())
+        return 1;
+
+    char line[128];
+    unsigned int lineNumber = 0;
+    while (fgets(line, sizeof(line), script) != NULL)
+    {
+        lineNumber++;
+        if (!runCommand(line))
+        {
+            fprintf(stderr, "line %u: unknown command: %s", lineNumber, line);
+            return 1;
+        }
+    }
+    if (realTime)
+        runInRealTime();
+    hostFlushTrace();
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*==============================================================================
+ File: hostUsb.c
+
+ The model of the PIC16F1459's USB module described in hostUsb.h. The
+ registers are the plain bytes declared in the host xc.h; the buffer
+ descriptor table and the buffers are the firmware's own variables, found
+ by the symbols __at() gives them (see xc.h).
+==============================================================================*/
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "xc.h"
+#include "hostUsb.h"
+
+// The USB RAM the firmware places with __at(): usbCdc.c's buffer descriptor table, with four
+// bytes (status, count and address) per endpoint and direction, and its endpoint buffers.  A
+// buffer moved in usbCdc.c must be moved here too, or the build won't link.
+extern volatile unsigned char hostBdt[24] __asm__("hostRam0x2000");
+extern volatile unsigned char hostEp0OutBuffer[8] __asm__("hostRam0x2018");
+extern volatile unsigned char hostEp0InBuffer[8] __asm__("hostRam0x2020");
+extern volatile unsigned char hostEp2OutBuffer[16] __asm__("hostRam0x2030");
+extern volatile unsigned char hostEp2InBuffer[16] __asm__("hostRam0x2040");
+
+static const struct
+{
+    unsigned int address;
+    volatile unsigned char *bytes;
+    unsigned char length;
+} usbRam[] = {
+    {0x2018, hostEp0OutBuffer, sizeof(hostEp0OutBuffer)},
+    {0x2020, hostEp0InBuffer, sizeof(hostEp0InBuffer)},
+    {0x2030, hostEp2OutBuffer, sizeof(hostEp2OutBuffer)},
+    {0x2040, hostEp2InBuffer, sizeof(hostEp2InBuffer)},
+};
+
+#define BD_COUNT (sizeof(hostBdt) / 4)
+#define BD_STAT(bd) hostBdt[(bd) * 4]
+#define BD_CNT(bd) hostBdt[(bd) * 4 + 1]
+#define BD_ADRL(bd) hostBdt[(bd) * 4 + 2]
+#define BD_ADRH(bd) hostBdt[(bd) * 4 + 3]
+
+#define BD_UOWN 0x80
+#define BD_DTS 0x40
+#define BD_DTSEN 0x08
+#define BD_BSTALL 0x04
+
+#define PID_OUT 0x1
+#define PID_IN 0x9
+#define PID_SETUP 0xD
+
+#define UEP_EPSTALL 0x01
+#define UEP_EPINEN 0x02
+#define UEP_EPOUTEN 0x04
+#define UEP_EPCONDIS 0x08
+
+// The completed transfers not yet taken by the firmware, as the USTAT values that report them.
+// The first is in USTAT while TRNIF is set; clearing TRNIF moves on to the next.
+#define USTAT_FIFO_SIZE 4
+static unsigned char ustatFifo[USTAT_FIFO_SIZE];
+static unsigned char ustatCount = 0;
+static bool ustatShown = false;
+
+static unsigned int errors = 0;
+
+// Show the firmware the next completed transfer, once it has cleared TRNIF for the last one
+static void updateUstat(void)
+{
+    if (ustatShown && !UIRbits.TRNIF)
+    {
+        ustatCount--;
+        for (unsigned char i = 0; i < ustatCount; i++)
+            ustatFifo[i] = ustatFifo[i + 1];
+        ustatShown = false;
+    }
+    if (!ustatShown && ustatCount > 0)
+    {
+        USTAT = ustatFifo[0];
+        UIRbits.TRNIF = 1;
+        ustatShown = true;
+    }
+}
+
+static volatile unsigned char *endpointControl(unsigned char endpoint)
+{
+    switch (endpoint)
+    {
+    case 0:
+        return &UEP0;
+    case 1:
+        return &UEP1;
+    case 2:
+        return &UEP2;
+    default:
+        return NULL;
+    }
+}
+
+// Returns the byte of USB RAM at offset in a buffer descriptor's buffer, or NULL if the firmware
+// didn't place a buffer there
+static volatile unsigned char *bufferByte(unsigned char bd, unsigned char offset)
+{
+    unsigned int address = (BD_ADRH(bd) << 8 | BD_ADRL(bd)) + offset;
+    for (size_t i = 0; i < sizeof(usbRam) / sizeof(usbRam[0]); i++)
+        if (address >= usbRam[i].address && address < usbRam[i].address + usbRam[i].length)
+            return usbRam[i].bytes + (address - usbRam[i].address);
+    errors++;
+    return NULL;
+}
+
+// The checks every transaction goes through, up to the point where the buffer descriptor
+// decides the handshake.  Returns the buffer descriptor's index, or -1 with the handshake.
+static int startTransaction(unsigned char address, unsigned char endpoint, bool in, bool setup,
+                            enum hostUsbHandshake *handshake)
+{
+    unsigned char enable = in ? UEP_EPINEN : UEP_EPOUTEN;
+    updateUstat();
+    volatile unsigned char *control = endpointControl(endpoint);
+    *handshake = HOST_USB_NO_ANSWER;
+    if (!UCONbits.USBEN || UCONbits.SUSPND || address != UADDR || control == NULL ||
+        (*control & enable) == 0 || (setup && (*control & UEP_EPCONDIS)))
+        return -1;
+    UIRbits.ACTVIF = 1;
+
+    unsigned char bd = endpoint * 2 + in;
+    if (bd >= BD_COUNT)
+        return -1;
+    // A SETUP is taken even by a stalled endpoint
+    if (!setup && (*control & UEP_EPSTALL))
+    {
+        *handshake = HOST_USB_STALL;
+        return -1;
+    }
+    // While a setup is being dealt with, or the USTAT FIFO is full, the SIE takes no packets
+    *handshake = HOST_USB_NAK;
+    if (UCONbits.PKTDIS || ustatCount == USTAT_FIFO_SIZE)
+        return -1;
+    return bd;
+}
+
+// Hand a buffer back to the firmware and queue the transfer for USTAT
+static void completeTransfer(unsigned char bd, unsigned char pid, bool data1)
+{
+    BD_STAT(bd) = pid << 2 | (data1 ? BD_DTS : 0);
+    ustatFifo[ustatCount++] = bd << 2;
+    updateUstat();
+}
+
+bool hostUsbBusReset(void)
+{
+    if (!UCONbits.USBEN || !UCFGbits.UPUEN)
+        return false;
+    // Transfers left from before the reset aren't modelled: the firmware throws them away
+    ustatCount = 0;
+    ustatShown = false;
+    UIRbits.TRNIF = 0;
+    UADDR = 0;
+    UIRbits.URSTIF = 1;
+    return true;
+}
+
+enum hostUsbHandshake hostUsbSetup(unsigned char address, const unsigned char *packet)
+{
+    enum hostUsbHandshake handshake;
+    int bd = startTransaction(address, 0, false, true, &handshake);
+    if (bd < 0)
+        return handshake;
+    // BSTALL doesn't stop a SETUP either, but it only goes into a buffer the SIE owns
+    if (!(BD_STAT(bd) & BD_UOWN))
+        return HOST_USB_NAK;
+    if (BD_CNT(bd) < 8)
+    {
+        errors++;
+        return HOST_USB_NAK;
+    }
+    for (unsigned char i = 0; i < 8; i++)
+    {
+        volatile unsigned char *byte = bufferByte(bd, i);
+        if (byte == NULL)
+            return HOST_USB_NAK;
+        *byte = packet[i];
+    }
+    BD_CNT(bd) = 8;
+    completeTransfer(bd, PID_SETUP, false);
+    UCONbits.PKTDIS = 1;
+    return HOST_USB_ACK;
+}
+
+enum hostUsbHandshake hostUsbOut(unsigned char address, unsigned char endpoint, bool data1,
+                                 const unsigned char *data, unsigned char length)
+{
+    enum hostUsbHandshake handshake;
+    int bd = startTransaction(address, endpoint, false, false, &handshake);
+    if (bd < 0)
+        return handshake;
+    unsigned char stat = BD_STAT(bd);
+    if (!(stat & BD_UOWN))
+        return HOST_USB_NAK;
+    if (stat & BD_BSTALL)
+    {
+        UIRbits.STALLIF = 1;
+        return HOST_USB_STALL;
+    }
+    // A packet with the wrong data toggle is a repeat of one whose ACK the computer missed: it
+    // is ACK'd again, but the buffer is left as it is
+    if ((stat & BD_DTSEN) && data1 != ((stat & BD_DTS) != 0))
+        return HOST_USB_ACK;
+    if (length > BD_CNT(bd))
+    {
+        errors++;
+        return HOST_USB_NAK;
+    }
+    for (unsigned char i = 0; i < length; i++)
+    {
+        volatile unsigned char *byte = bufferByte(bd, i);
+        if (byte == NULL)
+            return HOST_USB_NAK;
+        *byte = data[i];
+    }
+    BD_CNT(bd) = length;
+    completeTransfer(bd, PID_OUT, data1);
+    return HOST_USB_ACK;
+}
+
+enum hostUsbHandshake hostUsbIn(unsigned char address, unsigned char endpoint, bool *data1,
+                                unsigned char *data, unsigned char *length)
+{
+    enum hostUsbHandshake handshake;
+    int bd = startTransaction(address, endpoint, true, false, &handshake);
+    if (bd < 0)
+        return handshake;
+    unsigned char stat = BD_STAT(bd);
+    if (!(stat & BD_UOWN))
+        return HOST_USB_NAK;
+    if (stat & BD_BSTALL)
+    {
+        UIRbits.STALLIF = 1;
+        return HOST_USB_STALL;
+    }
+    *length = BD_CNT(bd);
+    if (*length > 64)
+    {
+        errors++;
+        return HOST_USB_NAK;
+    }
+    for (unsigned char i = 0; i < *length; i++)
+    {
+        volatile unsigned char *byte = bufferByte(bd, i);
+        if (byte == NULL)
+            return HOST_USB_NAK;
+        data[i] = *byte;
+    }
+    *data1 = (stat & BD_DTS) != 0;
+    completeTransfer(bd, PID_IN, *data1);
+    return HOST_USB_ACK;
+}
+
+unsigned int hostUsbErrors(void)
+{
+    return errors;
+}
@@ -0,0 +1,64 @@
+/*==============================================================================
+ File: hostUsb.h
+
+ A model of the PIC16F1459's USB module (its serial interface engine, or
+ SIE), for running usbCdc.c on the host in place of hostUsbCdc.c. The caller
+ plays the computer: it resets the bus and sends tokens one transaction at a
+ time, and the model answers from the buffer descriptor table and USB RAM the
+ firmware set up, as the SIE would. Between transactions the firmware has to
+ be run, as only it can turn a completed transfer into the next one.
+
+ What is modelled: the USTAT FIFO and TRNIF, PKTDIS after a SETUP, UADDR,
+ the endpoint enables and stalls in UEPn, buffer ownership (UOWN), STALLs from
+ BSTALL, and the data toggle check (DTSEN). Ping-pong buffering, suspend and
+ resume signalling, start of frame, bus errors and the USB interrupt are
+ not: the driver doesn't use them, apart from suspend, which is only seen
+ as the module not answering.
+==============================================================================*/
+
+#ifndef HOST_USB_H
+#define HOST_USB_H
+
+#include <stdbool.h>
+
+// How a transaction ended, as the computer sees it
+enum hostUsbHandshake
+{
+    HOST_USB_ACK,
+    HOST_USB_NAK,
+    HOST_USB_STALL,
+    HOST_USB_NO_ANSWER // The module is off or suspended, or not at this address or endpoint
+};
+
+/**
+ * Reset the bus, as a computer does when the device is plugged in.  Returns false if the
+ * device isn't attached: the module is off or its pull-up isn't on.
+ */
+bool hostUsbBusReset(void);
+
+/**
+ * Send a SETUP transaction's 8 bytes to endpoint 0 at a device address
+ */
+enum hostUsbHandshake hostUsbSetup(unsigned char address, const unsigned char *packet);
+
+/**
+ * Send an OUT transaction of up to 64 bytes, as a DATA1 (data1 true) or DATA0 packet
+ */
+enum hostUsbHandshake hostUsbOut(unsigned char address, unsigned char endpoint, bool data1,
+                                 const unsigned char *data, unsigned char length);
+
+/**
+ * Send an IN token.  When the device answers with data (HOST_USB_ACK), the packet is copied
+ * into data, which must have room for 64 bytes, and its length and data toggle are returned.
+ */
+enum hostUsbHandshake hostUsbIn(unsigned char address, unsigned char endpoint, bool *data1,
+                                unsigned char *data, unsigned char *length);
+
+/**
+ * Returns the number of mistakes the firmware made that the model could see: a buffer
+ * descriptor pointing outside the USB RAM the firmware placed, or a packet longer than the
+ * buffer it was given (or a SETUP buffer shorter than 8 bytes)
+ */
+unsigned int hostUsbErrors(void);
+
+#endif
@@ -0,0 +1,134 @@
+/*==============================================================================
+ File: hostUsbCdc.c
+
+ Stands in for usbCdc.c, which drives the PIC's USB module, by carrying the
+ serial channel's text to and from the host instead. Text comes from the
+ script's serial commands, or from a pseudo-terminal that a terminal program
+ can open, and is moved a packet at a time as the USB driver would. Once
+ the port has been used it counts as configured, so the PIC doesn't sleep.
+ Text sent to the computer is traced a line at a time, or when it stops
+ coming:
+
+   <ms> SERIAL "<text>"
+==============================================================================*/
+
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "xc.h"
+#include "hostHardware.h"
+#include "../serial.h"
+#include "../usbCdc.h"
+
+// Text from the computer that the firmware hasn't taken yet
+static char pendingInput[256];
+static size_t pendingLength = 0;
+
+// The line being sent to the computer, traced once it ends or the output goes quiet
+static char outputLine[80];
+static size_t outputLength = 0;
+
+static int pty = -1;
+
+// Set once a computer has used the port, after which it counts as configured and the PIC
+// mustn't sleep
+static bool portUsed = false;
+
+bool hostOpenSerialPty(void)
+{
+    pty = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty < 0 || grantpt(pty) != 0 || unlockpt(pty) != 0)
+    {
+        perror("pty");
+        return false;
+    }
+    struct termios settings;
+    tcgetattr(pty, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(pty, TCSANOW, &settings);
+    fcntl(pty, F_SETFL, O_NONBLOCK);
+    fprintf(stderr, "serial port: %s\n", ptsname(pty));
+    portUsed = true;
+    return true;
+}
+
+void hostSerialInput(const char *text)
+{
+    size_t length = strlen(text);
+    if (length > sizeof(pendingInput) - pendingLength)
+        length = sizeof(pendingInput) - pendingLength;
+    memcpy(pendingInput + pendingLength, text, length);
+    pendingLength += length;
+    portUsed = true;
+}
+
+static void traceOutputLine(void)
+{
+    outputLine[outputLength] = '\0';
+    if (hostTrace != NULL)
+        fprintf(hostTrace, "%.3f SERIAL \"%s\"\n", (double)hostGetCycles() / HOST_CYCLES_PER_MS, outputLine);
+    outputLength = 0;
+}
+
+void initUsbCdc(void)
+{
+    pendingLength = 0;
+    outputLength = 0;
+    portUsed = pty >= 0;
+}
+
+void serviceUsbCdc(void)
+{
+    if (pty >= 0 && pendingLength < sizeof(pendingInput))
+    {
+        ssize_t count = read(pty, pendingInput + pendingLength, sizeof(pendingInput) - pendingLength);
+        if (count > 0)
+            pendingLength += count;
+    }
+
+    // A packet only comes in once there is room for a whole one
+    if (pendingLength > 0 && serialInputSpace() >= USB_CDC_PACKET_SIZE)
+    {
+        size_t count = pendingLength < USB_CDC_PACKET_SIZE ? pendingLength : USB_CDC_PACKET_SIZE;
+        for (size_t i = 0; i < count; i++)
+            putSerialInput(pendingInput[i]);
+        memmove(pendingInput, pendingInput + count, pendingLength - count);
+        pendingLength -= count;
+    }
+
+    char packet[USB_CDC_PACKET_SIZE];
+    size_t count = 0;
+    while (count < USB_CDC_PACKET_SIZE - 1 && takeSerialOutput(&packet[count]))
+        count++;
+    if (pty >= 0 && count > 0 && write(pty, packet, count) < 0)
+    {
+        // Nobody has the terminal open, so the text is lost as it would be on USB
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (packet[i] == '\n')
+            traceOutputLine();
+        else if (packet[i] != '\r' && outputLength < sizeof(outputLine) - 1)
+            outputLine[outputLength++] = packet[i];
+    }
+    if (count == 0 && outputLength > 0)
+        traceOutputLine();
+}
+
+bool prepareUsbCdcForSleep(void)
+{
+    return !portUsed;
+}
+
+bool resumeUsbCdc(void)
+{
+    return false;
+}
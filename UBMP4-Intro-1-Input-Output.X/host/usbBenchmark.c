@@ -0,0 +1,296 @@
+/*==============================================================================
+ File: usbBenchmark.c
+
+ Runs the firmware with the USB driver in usbCdc.c, against the model of
+ the USB module in hostUsb.c, and plays the computer: it resets the bus,
+ enumerates and configures the serial port as an operating system would,
+ then types a command and reads the reply. The main loop runs a pass
+ between transactions, and a transaction the firmware NAKs is tried again
+ after each pass. Each result is one JSON object per line:
+
+   {"bench":"usb_control", ...} each control transfer: the request, the bytes
+                            in its data stage, the packets they took, and
+                            whether the handshakes, data toggles and reply
+                            were as expected
+   {"bench":"usb_serial", ...} a command sent on the bulk OUT endpoint, sent
+                            again with the same data toggle (as when the
+                            computer misses the ACK) and then sent once
+                            more, and the replies read from the bulk IN
+                            endpoint, which should answer the command twice
+   {"bench":"summary", ...} the number of results that are wrong, and the
+                            number of mistakes the USB module's model saw
+                            the firmware make
+
+ This checks the driver against a model written from the datasheet, not
+ against the PIC's USB module itself.
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "xc.h"
+#include "hostHardware.h"
+#include "hostUsb.h"
+#include "../lcd.h"
+#include "../display.h"
+
+// The address the computer gives the device
+#define USB_ADDRESS 5
+
+// How many main loop passes a transaction may be NAK'd for before the bench gives up
+#define MAX_NAK_PASSES 20
+
+static unsigned int failures = 0;
+
+static void runPass(void)
+{
+    runMorseCode();
+    hostDelayCycles(200);
+}
+
+// Send a token, running the main loop between tries while the firmware NAKs it
+static enum hostUsbHandshake sendSetup(unsigned char address, const unsigned char *packet)
+{
+    enum hostUsbHandshake handshake = hostUsbSetup(address, packet);
+    for (unsigned int pass = 0; handshake == HOST_USB_NAK && pass < MAX_NAK_PASSES; pass++)
+    {
+        runPass();
+        handshake = hostUsbSetup(address, packet);
+    }
+    return handshake;
+}
+
+static enum hostUsbHandshake sendOut(unsigned char address, unsigned char endpoint, bool data1,
+                                     const unsigned char *data, unsigned char length)
+{
+    enum hostUsbHandshake handshake = hostUsbOut(address, endpoint, data1, data, length);
+    for (unsigned int pass = 0; handshake == HOST_USB_NAK && pass < MAX_NAK_PASSES; pass++)
+    {
+        runPass();
+        handshake = hostUsbOut(address, endpoint, data1, data, length);
+    }
+    return handshake;
+}
+
+static enum hostUsbHandshake sendIn(unsigned char address, unsigned char endpoint, bool *data1,
+                                    unsigned char *data, unsigned char *length)
+{
+    enum hostUsbHandshake handshake = hostUsbIn(address, endpoint, data1, data, length);
+    for (unsigned int pass = 0; handshake == HOST_USB_NAK && pass < MAX_NAK_PASSES; pass++)
+    {
+        runPass();
+        handshake = hostUsbIn(address, endpoint, data1, data, length);
+    }
+    return handshake;
+}
+
+// Carry out a control transfer on endpoint 0: the setup, the data stage (read into or written
+// from data, up to the setup's length) and the status stage.  Returns how the first stage that
+// wasn't ACK'd ended, or HOST_USB_ACK; the bytes and packets of the data stage are counted, and
+// wrong data toggles or a data stage that goes on too long are counted as errors.
+static enum hostUsbHandshake controlTransfer(unsigned char address, const unsigned char *setup,
+                                             unsigned char *data, unsigned int *bytes,
+                                             unsigned int *packets, unsigned int *errors)
+{
+    bool read = (setup[0] & 0x80) != 0;
+    unsigned int length = setup[6] | setup[7] << 8;
+    *bytes = 0;
+    *packets = 0;
+    *errors = 0;
+
+    enum hostUsbHandshake handshake = sendSetup(address, setup);
+    if (handshake != HOST_USB_ACK)
+        return handshake;
+    runPass();
+
+    // The data stage starts with DATA1 and alternates
+    bool toggle = true;
+    unsigned char packet[64];
+    unsigned char packetLength;
+    bool packetData1;
+    if (read)
+    {
+        do
+        {
+            handshake = sendIn(address, 0, &packetData1, packet, &packetLength);
+            if (handshake != HOST_USB_ACK)
+                return handshake;
+            *errors += packetData1 != toggle || *bytes + packetLength > length;
+            for (unsigned char i = 0; i < packetLength && *bytes < length; i++)
+                data[(*bytes)++] = packet[i];
+            ++*packets;
+            toggle = !toggle;
+            runPass();
+        } while (packetLength == 8 && *bytes < length);
+        // The status stage is a zero-length DATA1 packet from the computer
+        return sendOut(address, 0, true, NULL, 0);
+    }
+
+    while (*bytes < length)
+    {
+        unsigned char count = length - *bytes < 8 ? length - *bytes : 8;
+        handshake = sendOut(address, 0, toggle, data + *bytes, count);
+        if (handshake != HOST_USB_ACK)
+            return handshake;
+        *bytes += count;
+        ++*packets;
+        toggle = !toggle;
+        runPass();
+    }
+    // The status stage is a zero-length DATA1 packet from the device
+    handshake = sendIn(address, 0, &packetData1, packet, &packetLength);
+    *errors += handshake == HOST_USB_ACK && (packetLength != 0 || !packetData1);
+    runPass();
+    return handshake;
+}
+
+static const char *const handshakeNames[] = {"ACK", "NAK", "STALL", "none"};
+
+// Run one control transfer and check how it ended and, for a read, its length and the start of
+// the reply (as many bytes as expectedStart has)
+static void benchmarkControl(const char *name, unsigned char address, const unsigned char *setup,
+                             unsigned char *data, enum hostUsbHandshake expected,
+                             const unsigned char *expectedStart, unsigned int startLength,
+                             unsigned int expectedBytes)
+{
+    unsigned int bytes, packets, errors;
+    enum hostUsbHandshake handshake = controlTransfer(address, setup, data, &bytes, &packets, &errors);
+    bool ok = handshake == expected && errors == 0;
+    if (ok && expected == HOST_USB_ACK && (setup[0] & 0x80))
+        ok = bytes == expectedBytes && memcmp(data, expectedStart, startLength) == 0;
+    failures += !ok;
+    printf("{\"bench\":\"usb_control\",\"request\":\"%s\",\"handshake\":\"%s\",\"bytes\":%u,"
+           "\"packets\":%u,\"toggle_errors\":%u,\"ok\":%s}\n",
+           name, handshakeNames[handshake], bytes, packets, errors, ok ? "true" : "false");
+}
+
+static void benchmarkEnumeration(void)
+{
+    unsigned char data[256];
+
+    bool attached = hostUsbBusReset();
+    runPass();
+    failures += !attached;
+    printf("{\"bench\":\"usb_control\",\"request\":\"bus reset\",\"attached\":%s,\"ok\":%s}\n",
+           attached ? "true" : "false", attached ? "true" : "false");
+
+    // Linux asks for 64 bytes of the device descriptor at address 0 to learn endpoint 0's size
+    static const unsigned char getDevice64[] = {0x80, 0x06, 0x00, 0x01, 0x00, 0x00, 64, 0};
+    static const unsigned char deviceStart[] = {18, 1, 0x00, 0x02, 0x02, 0x00, 0x00, 8, 0xD8, 0x04};
+    benchmarkControl("GET_DESCRIPTOR device (64)", 0, getDevice64, data, HOST_USB_ACK,
+                     deviceStart, sizeof(deviceStart), 18);
+
+    // The new address only answers once the status stage is over
+    static const unsigned char setAddress[] = {0x00, 0x05, USB_ADDRESS, 0x00, 0x00, 0x00, 0, 0};
+    benchmarkControl("SET_ADDRESS", 0, setAddress, data, HOST_USB_ACK, NULL, 0, 0);
+    static const unsigned char getDevice18[] = {0x80, 0x06, 0x00, 0x01, 0x00, 0x00, 18, 0};
+    benchmarkControl("GET_DESCRIPTOR device at the old address", 0, getDevice18, data,
+                     HOST_USB_NO_ANSWER, NULL, 0, 0);
+    benchmarkControl("GET_DESCRIPTOR device", USB_ADDRESS, getDevice18, data, HOST_USB_ACK,
+                     deviceStart, sizeof(deviceStart), 18);
+
+    static const unsigned char getConfiguration9[] = {0x80, 0x06, 0x00, 0x02, 0x00, 0x00, 9, 0};
+    static const unsigned char configurationStart[] = {9, 2, 67, 0, 2, 1, 0, 0x80};
+    benchmarkControl("GET_DESCRIPTOR configuration (9)", USB_ADDRESS, getConfiguration9, data,
+                     HOST_USB_ACK, configurationStart, sizeof(configurationStart), 9);
+    static const unsigned char getConfiguration255[] = {0x80, 0x06, 0x00, 0x02, 0x00, 0x00, 255, 0};
+    benchmarkControl("GET_DESCRIPTOR configuration", USB_ADDRESS, getConfiguration255, data,
+                     HOST_USB_ACK, configurationStart, sizeof(configurationStart), 67);
+
+    static const unsigned char getLanguages[] = {0x80, 0x06, 0x00, 0x03, 0x00, 0x00, 255, 0};
+    static const unsigned char languages[] = {4, 3, 0x09, 0x04};
+    benchmarkControl("GET_DESCRIPTOR string 0", USB_ADDRESS, getLanguages, data, HOST_USB_ACK,
+                     languages, sizeof(languages), 4);
+    static const unsigned char getProduct[] = {0x80, 0x06, 0x01, 0x03, 0x09, 0x04, 255, 0};
+    static const unsigned char productStart[] = {34, 3, 'U', 0, 'B', 0, 'M', 0};
+    benchmarkControl("GET_DESCRIPTOR string 1", USB_ADDRESS, getProduct, data, HOST_USB_ACK,
+                     productStart, sizeof(productStart), 34);
+
+    // A full speed device has no device qualifier, and says so with a STALL.  The next setup
+    // must be taken all the same.
+    static const unsigned char getQualifier[] = {0x80, 0x06, 0x00, 0x06, 0x00, 0x00, 10, 0};
+    benchmarkControl("GET_DESCRIPTOR device qualifier", USB_ADDRESS, getQualifier, data, HOST_USB_STALL,
+                     NULL, 0, 0);
+
+    static const unsigned char setConfiguration[] = {0x00, 0x09, 0x01, 0x00, 0x00, 0x00, 0, 0};
+    benchmarkControl("SET_CONFIGURATION", USB_ADDRESS, setConfiguration, data, HOST_USB_ACK, NULL, 0, 0);
+    static const unsigned char getConfiguration[] = {0x80, 0x08, 0x00, 0x00, 0x00, 0x00, 1, 0};
+    static const unsigned char configured[] = {1};
+    benchmarkControl("GET_CONFIGURATION", USB_ADDRESS, getConfiguration, data, HOST_USB_ACK,
+                     configured, sizeof(configured), 1);
+
+    // 115200 baud, 1 stop bit, no parity, 8 data bits, read back as it was set
+    static const unsigned char setLineCoding[] = {0x21, 0x20, 0x00, 0x00, 0x00, 0x00, 7, 0};
+    unsigned char lineCoding[] = {0x00, 0xC2, 0x01, 0x00, 0, 0, 8};
+    benchmarkControl("SET_LINE_CODING", USB_ADDRESS, setLineCoding, lineCoding, HOST_USB_ACK, NULL, 0, 0);
+    static const unsigned char getLineCoding[] = {0xA1, 0x21, 0x00, 0x00, 0x00, 0x00, 7, 0};
+    benchmarkControl("GET_LINE_CODING", USB_ADDRESS, getLineCoding, data, HOST_USB_ACK,
+                     lineCoding, sizeof(lineCoding), 7);
+
+    static const unsigned char setControlLineState[] = {0x21, 0x22, 0x03, 0x00, 0x00, 0x00, 0, 0};
+    benchmarkControl("SET_CONTROL_LINE_STATE", USB_ADDRESS, setControlLineState, data, HOST_USB_ACK,
+                     NULL, 0, 0);
+}
+
+// Send "?" (which the firmware answers with the LCD's status row) on endpoint 2 as DATA0, again
+// as DATA0, then as DATA1, and read the replies as they come
+static void benchmarkSerial(void)
+{
+    static const unsigned char command[] = {'?', '\r'};
+    bool sentOk = sendOut(USB_ADDRESS, 2, false, command, sizeof(command)) == HOST_USB_ACK &&
+                  sendOut(USB_ADDRESS, 2, false, command, sizeof(command)) == HOST_USB_ACK;
+    runPass();
+    sentOk = sentOk && sendOut(USB_ADDRESS, 2, true, command, sizeof(command)) == HOST_USB_ACK;
+
+    char reply[128];
+    unsigned int replyLength = 0;
+    unsigned int packets = 0;
+    unsigned int toggleErrors = 0;
+    bool toggle = false;
+    for (unsigned int pass = 0; pass < MAX_NAK_PASSES; pass++)
+    {
+        runPass();
+        unsigned char packet[64];
+        unsigned char packetLength;
+        bool packetData1;
+        while (hostUsbIn(USB_ADDRESS, 2, &packetData1, packet, &packetLength) == HOST_USB_ACK)
+        {
+            toggleErrors += packetData1 != toggle;
+            toggle = !toggle;
+            packets++;
+            for (unsigned char i = 0; i < packetLength && replyLength < sizeof(reply) - 1; i++)
+                reply[replyLength++] = packet[i];
+            runPass();
+        }
+    }
+    reply[replyLength] = '\0';
+
+    char expected[2 * (LCD_COLUMNS + 2) + 1];
+    for (unsigned char line = 0; line < 2; line++)
+    {
+        char *text = expected + line * (LCD_COLUMNS + 2);
+        memcpy(text, lcdScreen[DISPLAY_STATUS_ROW], LCD_COLUMNS);
+        memcpy(text + LCD_COLUMNS, "\r\n", 2);
+    }
+    expected[sizeof(expected) - 1] = '\0';
+
+    bool ok = sentOk && toggleErrors == 0 && strcmp(reply, expected) == 0;
+    failures += !ok;
+    printf("{\"bench\":\"usb_serial\",\"sent\":\"?\",\"reply_bytes\":%u,\"packets\":%u,"
+           "\"toggle_errors\":%u,\"ok\":%s}\n",
+           replyLength, packets, toggleErrors, ok ? "true" : "false");
+}
+
+int main(void)
+{
+    hostPowerOn();
+    setupMorseCode();
+
+    benchmarkEnumeration();
+    benchmarkSerial();
+
+    failures += hostUsbErrors() != 0;
+    printf("{\"bench\":\"summary\",\"failures\":%u,\"usb_errors\":%u}\n", failures, hostUsbErrors());
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*==============================================================================
+ File: xc.h (host backend)
+
+ Stands in for the XC8 compiler's xc.h when the firmware is built for Linux
+ with gcc. Each special function register is a plain byte, and its ...bits
+ structure is placed at the same address so both views stay in step, as they
+ do on the PIC. The peripherals behind the registers (timers, interrupt-on-
+ change, ADC, comparator, beeper and LEDs) are simulated against a virtual clock by
+ hostHardware.c, and the USB module by hostUsb.c.
+
+ Only the registers and bits used by the firmware are modelled. Add new ones
+ here (and their behaviour to hostHardware.c) as the firmware starts using
+ them.
+==============================================================================*/
+
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#define HOST_SFR(name) extern volatile unsigned char name
+#define HOST_SFR_BITS(name, ...) \
+    HOST_SFR(name);              \
+    extern volatile struct { __VA_ARGS__ } name##bits __asm__(#name)
+
+HOST_SFR_BITS(PORTA, unsigned RA0 : 1; unsigned RA1 : 1; unsigned RA2 : 1; unsigned RA3 : 1; unsigned RA4 : 1; unsigned RA5 : 1; unsigned : 1; unsigned : 1;);
+HOST_SFR_BITS(PORTB, unsigned : 1; unsigned : 1; unsigned : 1; unsigned : 1; unsigned RB4 : 1; unsigned RB5 : 1; unsigned RB6 : 1; unsigned RB7 : 1;);
+HOST_SFR_BITS(PORTC, unsigned RC0 : 1; unsigned RC1 : 1; unsigned RC2 : 1; unsigned RC3 : 1; unsigned RC4 : 1; unsigned RC5 : 1; unsigned RC6 : 1; unsigned RC7 : 1;);
+HOST_SFR_BITS(LATA, unsigned LATA0 : 1; unsigned LATA1 : 1; unsigned LATA2 : 1; unsigned LATA3 : 1; unsigned LATA4 : 1; unsigned LATA5 : 1; unsigned : 1; unsigned : 1;);
+HOST_SFR_BITS(LATB, unsigned : 1; unsigned : 1; unsigned : 1; unsigned : 1; unsigned LATB4 : 1; unsigned LATB5 : 1; unsigned LATB6 : 1; unsigned LATB7 : 1;);
+HOST_SFR_BITS(LATC, unsigned LATC0 : 1; unsigned LATC1 : 1; unsigned LATC2 : 1; unsigned LATC3 : 1; unsigned LATC4 : 1; unsigned LATC5 : 1; unsigned LATC6 : 1; unsigned LATC7 : 1;);
+HOST_SFR_BITS(TRISA, unsigned TRISA0 : 1; unsigned TRISA1 : 1; unsigned TRISA2 : 1; unsigned TRISA3 : 1; unsigned TRISA4 : 1; unsigned TRISA5 : 1; unsigned : 1; unsigned : 1;);
+HOST_SFR_BITS(TRISB, unsigned : 1; unsigned : 1; unsigned : 1; unsigned : 1; unsigned TRISB4 : 1; unsigned TRISB5 : 1; unsigned TRISB6 : 1; unsigned TRISB7 : 1;);
+HOST_SFR_BITS(TRISC, unsigned TRISC0 : 1; unsigned TRISC1 : 1; unsigned TRISC2 : 1; unsigned TRISC3 : 1; unsigned TRISC4 : 1; unsigned TRISC5 : 1; unsigned TRISC6 : 1; unsigned TRISC7 : 1;);
+HOST_SFR(ANSELA);
+HOST_SFR(ANSELB);
+HOST_SFR_BITS(ANSELC, unsigned ANSC0 : 1; unsigned ANSC1 : 1; unsigned ANSC2 : 1; unsigned ANSC3 : 1; unsigned : 1; unsigned : 1; unsigned ANSC6 : 1; unsigned ANSC7 : 1;);
+HOST_SFR(WPUA);
+HOST_SFR(WPUB);
+HOST_SFR_BITS(OPTION_REG, unsigned PS0 : 1; unsigned PS1 : 1; unsigned PS2 : 1; unsigned PSA : 1; unsigned TMR0SE : 1; unsigned TMR0CS : 1; unsigned INTEDG : 1; unsigned nWPUEN : 1;);
+HOST_SFR_BITS(INTCON, unsigned IOCIF : 1; unsigned INTF : 1; unsigned TMR0IF : 1; unsigned IOCIE : 1; unsigned INTE : 1; unsigned TMR0IE : 1; unsigned PEIE : 1; unsigned GIE : 1;);
+HOST_SFR_BITS(PIE1, unsigned TMR1IE : 1; unsigned TMR2IE : 1; unsigned : 1; unsigned SSP1IE : 1; unsigned TXIE : 1; unsigned RCIE : 1; unsigned ADIE : 1; unsigned TMR1GIE : 1;);
+HOST_SFR_BITS(PIR1, unsigned TMR1IF : 1; unsigned TMR2IF : 1; unsigned : 1; unsigned SSP1IF : 1; unsigned TXIF : 1; unsigned RCIF : 1; unsigned ADIF : 1; unsigned TMR1GIF : 1;);
+HOST_SFR_BITS(PIE2, unsigned : 1; unsigned ACTIE : 1; unsigned USBIE : 1; unsigned BCL1IE : 1; unsigned : 1; unsigned C1IE : 1; unsigned C2IE : 1; unsigned OSFIE : 1;);
+HOST_SFR_BITS(PIR2, unsigned : 1; unsigned ACTIF : 1; unsigned USBIF : 1; unsigned BCL1IF : 1; unsigned : 1; unsigned C1IF : 1; unsigned C2IF : 1; unsigned OSFIF : 1;);
+HOST_SFR_BITS(IOCAP, unsigned IOCAP0 : 1; unsigned IOCAP1 : 1; unsigned IOCAP2 : 1; unsigned IOCAP3 : 1; unsigned IOCAP4 : 1; unsigned IOCAP5 : 1; unsigned : 1; unsigned : 1;);
+HOST_SFR_BITS(IOCAN, unsigned IOCAN0 : 1; unsigned IOCAN1 : 1; unsigned IOCAN2 : 1; unsigned IOCAN3 : 1; unsigned IOCAN4 : 1; unsigned IOCAN5 : 1; unsigned : 1; unsigned : 1;);
+HOST_SFR_BITS(IOCAF, unsigned IOCAF0 : 1; unsigned IOCAF1 : 1; unsigned IOCAF2 : 1; unsigned IOCAF3 : 1; unsigned IOCAF4 : 1; unsigned IOCAF5 : 1; unsigned : 1; unsigned : 1;);
+HOST_SFR_BITS(IOCBP, unsigned : 1; unsigned : 1; unsigned : 1; unsigned : 1; unsigned IOCBP4 : 1; unsigned IOCBP5 : 1; unsigned IOCBP6 : 1; unsigned IOCBP7 : 1;);
+HOST_SFR_BITS(IOCBN, unsigned : 1; unsigned : 1; unsigned : 1; unsigned : 1; unsigned IOCBN4 : 1; unsigned IOCBN5 : 1; unsigned IOCBN6 : 1; unsigned IOCBN7 : 1;);
+HOST_SFR_BITS(IOCBF, unsigned : 1; unsigned : 1; unsigned : 1; unsigned : 1; unsigned IOCBF4 : 1; unsigned IOCBF5 : 1; unsigned IOCBF6 : 1; unsigned IOCBF7 : 1;);
+HOST_SFR(TMR0);
+HOST_SFR_BITS(T1CON, unsigned TMR1ON : 1; unsigned : 1; unsigned nT1SYNC : 1; unsigned T1OSCEN : 1; unsigned T1CKPS0 : 1; unsigned T1CKPS1 : 1; unsigned TMR1CS0 : 1; unsigned TMR1CS1 : 1;);
+HOST_SFR(TMR1L);
+HOST_SFR(TMR1H);
+HOST_SFR_BITS(T2CON, unsigned T2CKPS0 : 1; unsigned T2CKPS1 : 1; unsigned TMR2ON : 1; unsigned T2OUTPS0 : 1; unsigned T2OUTPS1 : 1; unsigned T2OUTPS2 : 1; unsigned T2OUTPS3 : 1; unsigned : 1;);
+HOST_SFR(TMR2);
+HOST_SFR(PR2);
+HOST_SFR_BITS(PWM1CON, unsigned : 1; unsigned : 1; unsigned : 1; unsigned : 1; unsigned PWM1POL : 1; unsigned PWM1OUT : 1; unsigned PWM1OE : 1; unsigned PWM1EN : 1;);
+HOST_SFR(PWM1DCL);
+HOST_SFR(PWM1DCH);
+HOST_SFR_BITS(ADCON0, unsigned ADON : 1; unsigned GO_nDONE : 1; unsigned CHS0 : 1; unsigned CHS1 : 1; unsigned CHS2 : 1; unsigned CHS3 : 1; unsigned CHS4 : 1; unsigned : 1;);
+HOST_SFR(ADCON1);
+HOST_SFR(ADCON2);
+HOST_SFR(ADRESL);
+HOST_SFR(ADRESH);
+HOST_SFR(OSCCON);
+HOST_SFR_BITS(OSCSTAT, unsigned HFIOFS : 1; unsigned LFIOFR : 1; unsigned : 1; unsigned : 1; unsigned HFIOFR : 1; unsigned OSTS : 1; unsigned PLLRDY : 1; unsigned SOSCR : 1;);
+HOST_SFR(ACTCON);
+HOST_SFR_BITS(FVRCON, unsigned ADFVR0 : 1; unsigned ADFVR1 : 1; unsigned CDAFVR0 : 1; unsigned CDAFVR1 : 1; unsigned TSRNG : 1; unsigned TSEN : 1; unsigned FVRRDY : 1; unsigned FVREN : 1;);
+HOST_SFR_BITS(CM2CON0, unsigned C2SYNC : 1; unsigned C2HYS : 1; unsigned C2SP : 1; unsigned : 1; unsigned C2POL : 1; unsigned C2OE : 1; unsigned C2OUT : 1; unsigned C2ON : 1;);
+HOST_SFR_BITS(CM2CON1, unsigned C2NCH0 : 1; unsigned C2NCH1 : 1; unsigned : 1; unsigned : 1; unsigned C2PCH0 : 1; unsigned C2PCH1 : 1; unsigned C2INTN : 1; unsigned C2INTP : 1;);
+HOST_SFR(PMADRL);
+HOST_SFR(PMADRH);
+HOST_SFR(PMDATL);
+HOST_SFR(PMDATH);
+HOST_SFR_BITS(PMCON1, unsigned RD : 1; unsigned WR : 1; unsigned WREN : 1; unsigned WRERR : 1; unsigned FREE : 1; unsigned LWLO : 1; unsigned CFGS : 1; unsigned : 1;);
+HOST_SFR(PMCON2);
+HOST_SFR_BITS(UCON, unsigned : 1; unsigned SUSPND : 1; unsigned RESUME : 1; unsigned USBEN : 1; unsigned PKTDIS : 1; unsigned SE0 : 1; unsigned PPBRST : 1; unsigned : 1;);
+HOST_SFR_BITS(UCFG, unsigned UPP0 : 1; unsigned UPP1 : 1; unsigned FSEN : 1; unsigned UTRDIS : 1; unsigned UPUEN : 1; unsigned : 1; unsigned : 1; unsigned UTEYE : 1;);
+HOST_SFR_BITS(UIR, unsigned URSTIF : 1; unsigned UERRIF : 1; unsigned ACTVIF : 1; unsigned TRNIF : 1; unsigned IDLEIF : 1; unsigned STALLIF : 1; unsigned SOFIF : 1; unsigned : 1;);
+HOST_SFR_BITS(UIE, unsigned URSTIE : 1; unsigned UERRIE : 1; unsigned ACTVIE : 1; unsigned TRNIE : 1; unsigned IDLEIE : 1; unsigned STALLIE : 1; unsigned SOFIE : 1; unsigned : 1;);
+HOST_SFR(UEIR);
+HOST_SFR(USTAT);
+HOST_SFR(UADDR);
+HOST_SFR_BITS(UEP0, unsigned EPSTALL : 1; unsigned EPINEN : 1; unsigned EPOUTEN : 1; unsigned EPCONDIS : 1; unsigned EPHSHK : 1; unsigned : 1; unsigned : 1; unsigned : 1;);
+HOST_SFR(UEP1);
+HOST_SFR(UEP2);
+
+// Legacy single bit names used by UBMP4.c.  As macros they hide the ...bits members of the same
+// name, so use these names on their own.
+#define GO ADCON0bits.GO_nDONE
+#define ADON ADCON0bits.ADON
+#define PLLRDY OSCSTATbits.PLLRDY
+
+// Time only passes in the simulation when the firmware waits, so delays and NOP() (used by the
+// firmware's busy-waits, and after starting a flash read, erase or write) advance the virtual clock.  _XTAL_FREQ comes from UBMP4.h.
+void hostDelayCycles(unsigned long long cycles);
+#define __delay_ms(x) hostDelayCycles((unsigned long long)(x) * (_XTAL_FREQ / 4000))
+#define __delay_us(x) hostDelayCycles((unsigned long long)(x) * (_XTAL_FREQ / 4000000))
+#define NOP() hostDelayCycles(1)
+
+// A variable placed with __at() (the USB driver's buffer descriptor table and buffers) gets a
+// symbol named after its address, e.g. hostRam0x2000, by which hostUsb.c finds the USB RAM the
+// descriptors point at
+#define __at(address) HOST_AT(address)
+#define HOST_AT(address) __asm__("hostRam" #address)
+
+// The interrupt handler is an ordinary function that hostHardware.c calls when an enabled
+// interrupt flag is set
+#define __interrupt(...)
+
+// SLEEP() stops the virtual clock's timers until an enabled interrupt flag is set
+void hostSleep(void);
+#define SLEEP() hostSleep()
+
+// A reset restarts the simulated firmware from its set-up code
+void hostReset(void);
+#define RESET() hostReset()
+
+#endif
@@ -0,0 +1,289 @@
+#include "xc.h"          // Microchip XC8 compiler include file
+#include "stdbool.h"     // Include Boolean (true/false) definition
+#include "UBMP4.h"       // Include UBMP4 constants and functions
+#include "convenience.h" // Include convenience utilities
+#include "scheduler.h"
+#include "buttons.h"
+#include "buzzer.h"
+#include "messageBuffer.h"
+#include "senderMode.h"
+#include "keyer.h"
+#include "display.h"
+
+unsigned int keyerUnitMs = UNIT_LENGTH_MS;
+enum keyerType currentKeyerType = ButtonKeyer;
+bool sidetoneEnabled = true;
+
+// The milliseconds left of the keyed mark, counted down by the tick, and whether it is sounding
+// the sidetone
+volatile unsigned int keyedMarkMsRemaining = 0;
+bool keyedMarkSounding = false;
+
+// When the key last went down and up
+unsigned int keyDownTime;
+unsigned int keyUpTime;
+
+void nextKeyerType()
+{
+    finishKeying();
+    switch (currentKeyerType)
+    {
+    case ButtonKeyer:
+        currentKeyerType = StraightKeyer;
+        FLASH_LED(5, UNIT_LENGTH_MS);
+        break;
+    case StraightKeyer:
+        currentKeyerType = IambicKeyerA;
+        FLASH_LED(6, UNIT_LENGTH_MS);
+        break;
+    case IambicKeyerA:
+        currentKeyerType = IambicKeyerB;
+        FLASH_2_LEDS(5, 6, UNIT_LENGTH_MS);
+        break;
+    case IambicKeyerB:
+        currentKeyerType = ButtonKeyer;
+        FLASH_LED(4, UNIT_LENGTH_MS);
+        break;
+    }
+}
+
+unsigned char keyerWpm()
+{
+    return WPM_UNIT_LENGTH_MS / keyerUnitMs;
+}
+
+void startKeyedMark(unsigned int lengthMs)
+{
+    // The sidetone takes over the buzzer, so repeated sounds can't cut into it
+    if (sidetoneEnabled)
+        cancelMultipleSound();
+
+    // Keep the tick from ending the previous mark half way through starting this one
+    INTCONbits.TMR0IE = 0;
+    keyedMarkSounding = sidetoneEnabled;
+    if (keyedMarkSounding)
+        startMorseCodeTone();
+    TURN_ON_LED(4);
+    IR_carrier_on();
+    keyedMarkMsRemaining = lengthMs;
+    INTCONbits.TMR0IE = 1;
+}
+
+void stopKeyedMark()
+{
+    INTCONbits.TMR0IE = 0;
+    if (keyedMarkMsRemaining > 0)
+    {
+        keyedMarkMsRemaining = 0;
+        if (keyedMarkSounding)
+            stopTone();
+        TURN_OFF_LED(4);
+        IR_carrier_off();
+    }
+    INTCONbits.TMR0IE = 1;
+}
+
+void handleKeyingTick()
+{
+    if (keyedMarkMsRemaining > 0 && keyedMarkMsRemaining != HELD_KEYED_MARK && --keyedMarkMsRemaining == 0)
+    {
+        if (keyedMarkSounding)
+            stopTone();
+        TURN_OFF_LED(4);
+        IR_carrier_off();
+    }
+}
+
+// Move the unit length half way towards a new measurement so it follows the operator
+// within a few elements, even from a very different starting speed
+unsigned int adaptUnitLength(unsigned int unitMs, unsigned int measuredUnitMs)
+{
+    unitMs = (unitMs + measuredUnitMs) / 2;
+    if (unitMs < MIN_KEYER_UNIT_MS)
+        return MIN_KEYER_UNIT_MS;
+    if (unitMs > MAX_KEYER_UNIT_MS)
+        return MAX_KEYER_UNIT_MS;
+    return unitMs;
+}
+
+// Scheduled when the key has been up for 5 units: the gap is between words
+void endOfWord()
+{
+    // Turn the letter gap we've already added into a word gap
+    if (getLastMessageElement() == CHAR_SEPARATOR)
+    {
+        replaceLastMessageElement(WORD_SEPARATOR);
+        showMessageElement(WORD_SEPARATOR);
+    }
+    else
+        pushToMessage(WORD_SEPARATOR);
+}
+
+// Scheduled when the key has been up for 2 units: the gap is between letters
+void endOfCharacter()
+{
+    pushToMessage(CHAR_SEPARATOR);
+    scheduleEvent(keyerUnitMs * 3, &endOfWord);
+}
+
+// Schedule a gap event for the given number of units after the key was released
+void scheduleGapEvent(unsigned char units, fScheduledEvent action)
+{
+    unsigned int elapsed = millis() - keyUpTime;
+    unsigned int due = keyerUnitMs * units;
+    scheduleEvent(elapsed < due ? due - elapsed : 0, action);
+}
+
+// The iambic keyer's state: the element being sent, and the paddles pressed since it started
+bool iambicKeyerRunning = false;
+char iambicElement;
+bool dotMemory = false;
+bool dashMemory = false;
+bool paddlesSqueezed = false;
+
+void endIambicMark();
+void endIambicGap();
+
+void startIambicElement(char element)
+{
+    iambicKeyerRunning = true;
+    iambicElement = element;
+    dotMemory = false;
+    dashMemory = false;
+    paddlesSqueezed = isButtonDown(3) && isButtonDown(4);
+
+    pushToMessage(element);
+    unsigned int markMs = element == DOT ? keyerUnitMs : keyerUnitMs * 3;
+    startKeyedMark(markMs);
+    scheduleEvent(markMs, &endIambicMark);
+}
+
+// Scheduled at the end of each element's mark, which the tick has already ended
+void endIambicMark()
+{
+    keyUpTime = millis();
+    scheduleEvent(keyerUnitMs, &endIambicGap);
+}
+
+// Scheduled one unit after each element to decide what comes next
+void endIambicGap()
+{
+    bool dotWanted = dotMemory || isButtonDown(3);
+    bool dashWanted = dashMemory || isButtonDown(4);
+
+    // In mode B a squeeze that was let go of during the element still earns one more opposite element
+    if (currentKeyerType == IambicKeyerB && paddlesSqueezed && !isButtonDown(3) && !isButtonDown(4))
+    {
+        if (iambicElement == DOT)
+            dashWanted = true;
+        else
+            dotWanted = true;
+    }
+
+    // Alternate while both paddles are wanted, otherwise repeat whichever one is
+    if (dotWanted && dashWanted)
+        startIambicElement(iambicElement == DOT ? DASH : DOT);
+    else if (dotWanted)
+        startIambicElement(DOT);
+    else if (dashWanted)
+        startIambicElement(DASH);
+    else
+    {
+        iambicKeyerRunning = false;
+        if (currentSenderState == AcceptingInput)
+            scheduleGapEvent(2, &endOfCharacter);
+    }
+}
+
+void stepIambicSpeed()
+{
+    unsigned char wpm = keyerWpm() + IAMBIC_WPM_STEP;
+    if (wpm > MAX_IAMBIC_WPM)
+        wpm = IAMBIC_WPM_STEP;
+    keyerUnitMs = WPM_UNIT_LENGTH_MS / wpm;
+}
+
+void processIambicKey(const struct buttonEvent *event)
+{
+    if (!event->pressed)
+    {
+        // Like SW2, SW5 acts on release so it can be part of the mode change combination
+        if (event->button == 5)
+        {
+            stepIambicSpeed();
+            FLASH_LED(6, UNIT_LENGTH_MS);
+        }
+        return;
+    }
+    if (event->button != 3 && event->button != 4)
+        return;
+
+    if (iambicKeyerRunning)
+    {
+        // Remember presses made while an element is sounding
+        if (event->button == 3)
+            dotMemory = true;
+        else
+            dashMemory = true;
+        if (isButtonDown(3) && isButtonDown(4))
+            paddlesSqueezed = true;
+        return;
+    }
+
+    cancelEvent(&endOfCharacter);
+    cancelEvent(&endOfWord);
+    startIambicElement(event->button == 3 ? DOT : DASH);
+}
+
+void finishKeying()
+{
+    cancelEvent(&endIambicMark);
+    cancelEvent(&endIambicGap);
+    iambicKeyerRunning = false;
+    cancelEvent(&endOfCharacter);
+    cancelEvent(&endOfWord);
+    stopKeyedMark();
+    stopTone();
+    TURN_OFF_LED(4);
+}
+
+void processStraightKey(const struct buttonEvent *event)
+{
+    if (event->button != 3)
+        return;
+
+    if (event->pressed)
+    {
+        // A gap of less than 2 units is the gap inside a letter, which is one unit long.  Longer gaps
+        // have already been added to the message by the gap events.
+        unsigned int gap = event->time - keyUpTime;
+        if (isEventScheduled(&endOfCharacter) && gap < keyerUnitMs * 2)
+            keyerUnitMs = adaptUnitLength(keyerUnitMs, gap);
+        cancelEvent(&endOfCharacter);
+        cancelEvent(&endOfWord);
+
+        keyDownTime = event->time;
+        startKeyedMark(HELD_KEYED_MARK);
+    }
+    else
+    {
+        stopKeyedMark();
+
+        // Marks shorter than 2 units are dots (1 unit) and longer ones are dashes (3 units)
+        unsigned int mark = event->time - keyDownTime;
+        if (mark < keyerUnitMs * 2)
+        {
+            pushToMessage(DOT);
+            keyerUnitMs = adaptUnitLength(keyerUnitMs, mark);
+        }
+        else
+        {
+            pushToMessage(DASH);
+            keyerUnitMs = adaptUnitLength(keyerUnitMs, mark / 3);
+        }
+
+        keyUpTime = event->time;
+        if (currentSenderState == AcceptingInput)
+            scheduleGapEvent(2, &endOfCharacter);
+    }
+}
@@ -0,0 +1,82 @@
+// The keyer turns button presses into Morse elements.  Besides the original buttons (SW3 dot,
+// SW4 dash, SW5 letter gap) SW3 can be used as a straight key: how long it is held and released
+// decides between dots, dashes and letter and word gaps, following the operator's speed.
+// SW3 and SW4 can also be used as the dot and dash paddles of an iambic keyer, which times the
+// elements itself at the keyer speed.
+
+// The length of one unit at 1 WPM (the word PARIS is 50 units long)
+#define WPM_UNIT_LENGTH_MS 1200
+#define MIN_KEYER_UNIT_MS 30  // 40 WPM
+#define MAX_KEYER_UNIT_MS 600 // 2 WPM
+
+// SW5 steps the iambic keyer speed up by this much, going back to the start after the maximum
+#define IAMBIC_WPM_STEP 5
+#define MAX_IAMBIC_WPM 30
+
+// The keyer's current estimate of the operator's unit length.  Messages are sent at this speed too.
+extern unsigned int keyerUnitMs;
+
+// Whether marks sound the sidetone as well as lighting LED4
+extern bool sidetoneEnabled;
+
+enum keyerType
+{
+    ButtonKeyer,
+    StraightKeyer,
+    IambicKeyerA, // Releasing both paddles stops after the current element
+    IambicKeyerB  // Releasing both paddles during a squeeze adds one more opposite element
+};
+extern enum keyerType currentKeyerType;
+
+/**
+ * Switch to the next keyer type and flash its LED (D4 buttons, D5 straight key, D6 iambic A,
+ * D5 and D6 iambic B)
+ */
+void nextKeyerType();
+
+/**
+ * Returns the unit length moved half way towards a new measurement of it (limited to
+ * MIN_KEYER_UNIT_MS-MAX_KEYER_UNIT_MS)
+ */
+unsigned int adaptUnitLength(unsigned int unitMs, unsigned int measuredUnitMs);
+
+/**
+ * Returns the operator's speed in words per minute
+ */
+unsigned char keyerWpm();
+
+/**
+ * Handle a button event while keying with SW3 as a straight key
+ */
+void processStraightKey(const struct buttonEvent *event);
+
+/**
+ * Handle a button event while keying with SW3 and SW4 as iambic paddles
+ */
+void processIambicKey(const struct buttonEvent *event);
+
+/**
+ * Stop any element timing that is still running, e.g. before the message is sent
+ */
+void finishKeying();
+
+// The length of a keyed mark that lasts until stopKeyedMark() ends it, e.g. while a straight key
+// is held down
+#define HELD_KEYED_MARK 0xFFFF
+
+/**
+ * Start a mark of the given length (or HELD_KEYED_MARK).  LED4, the sidetone and the IR carrier
+ * go on together now and the tick interrupt turns them off together, so what is heard matches
+ * what is seen and what another board receives.
+ */
+void startKeyedMark(unsigned int lengthMs);
+
+/**
+ * End the keyed mark early
+ */
+void stopKeyedMark();
+
+/**
+ * Time the keyed mark.  Call from the interrupt handler on every 1 ms tick.
+ */
+void handleKeyingTick();
@@ -0,0 +1,174 @@
+#include "xc.h"      // Microchip XC8 compiler include file
+#include "stdbool.h" // Include Boolean (true/false) definition
+#include "UBMP4.h"   // Include UBMP4 constants and functions
+#include "scheduler.h"
+#include "buttons.h"
+#include "receiverMode.h"
+#include "lcd.h"
+
+char lcdScreen[LCD_ROWS][LCD_COLUMNS];
+
+// One bit per column for the cells that have changed since they were copied to the module
+volatile unsigned int lcdDirty[LCD_ROWS];
+
+// The set-up sequence, one step per tick.  The first four steps only send their high nibble: they
+// get the module into 4-bit mode whatever mode it was left in.
+struct lcdSetupStep
+{
+    unsigned char command;
+    unsigned char waitMs; // Extra ticks to wait before the next step
+};
+const struct lcdSetupStep lcdSetupSteps[] = {
+    {0x30, 5},
+    {0x30, 0},
+    {0x30, 0},
+    {0x20, 0},
+    {LCD_4_BIT_2_LINES, 0},
+    {LCD_DISPLAY_ON, 0},
+    {LCD_ENTRY_INCREMENT, 0},
+    {LCD_CLEAR, 1},
+};
+#define LCD_NIBBLE_STEPS 4
+#define LCD_SETUP_STEPS (sizeof(lcdSetupSteps) / sizeof(lcdSetupSteps[0]))
+
+unsigned char lcdSetupIndex;
+unsigned char lcdWaitMs;
+
+// The display RAM address the module will put the next character at
+unsigned char lcdAddress;
+
+void initLcd()
+{
+    RS = 0;
+    EN = 0;
+    TRISCbits.TRISC0 = 0; // RS and EN are always driven, so EN can't float high
+    TRISCbits.TRISC1 = 0;
+
+    for (unsigned char row = 0; row < LCD_ROWS; row++)
+    {
+        for (unsigned char column = 0; column < LCD_COLUMNS; column++)
+            lcdScreen[row][column] = ' ';
+        lcdDirty[row] = 0;
+    }
+    lcdSetupIndex = 0;
+    lcdWaitMs = LCD_POWER_ON_MS;
+    lcdAddress = 0;
+}
+
+// Put a nibble on D4-D7 (RC2-RC5) and pulse EN.  The module reads it as EN falls.
+void writeLcdNibble(unsigned char nibble)
+{
+    LATC = (LATC & 0b11000011) | (nibble << 2);
+    EN = 1;
+    __delay_us(1);
+    EN = 0;
+    __delay_us(1);
+}
+
+// While Q1 is sampled, the latest TMR0 count at which a write may start: half way through the tick
+#define LCD_LATEST_WRITE_TMR0 (256 - TICK_COUNTS_PER_MS_HIGH / 2)
+
+// Send a command (rs false) or a character (rs true) to the module, borrowing the shared pins
+// for as long as it takes
+void writeLcd(bool rs, unsigned char value, bool highNibbleOnly)
+{
+    unsigned char lat = LATC;
+    unsigned char tris = TRISC;
+    bool carrier = PWM1CONbits.PWM1OE;
+
+    // Let the light sample Timer0 started at the tick finish converting before D5 (Q1) is driven
+    while (GO)
+        NOP();
+    PWM1CONbits.PWM1OE = 0; // The carrier's gap is far too short for a receiver to notice
+    TRISC = tris & 0b11000011;
+
+    RS = rs;
+    writeLcdNibble(value >> 4);
+    if (!highNibbleOnly)
+        writeLcdNibble(value & 0x0F);
+
+    LATC = lat;
+    TRISC = tris;
+    PWM1CONbits.PWM1OE = carrier;
+}
+
+void lcdPutChar(unsigned char row, unsigned char column, char c)
+{
+    if (lcdScreen[row][column] == c)
+        return;
+    lcdScreen[row][column] = c;
+
+    // The tick clears the bit just before it copies the cell, so a character written while the
+    // cell is being copied is copied again
+    INTCONbits.TMR0IE = 0;
+    lcdDirty[row] |= 1u << column;
+    INTCONbits.TMR0IE = 1;
+}
+
+void lcdPutString(unsigned char row, unsigned char column, const char *text)
+{
+    for (; *text != '\0' && column < LCD_COLUMNS; column++)
+        lcdPutChar(row, column, *text++);
+}
+
+void lcdClearRow(unsigned char row)
+{
+    for (unsigned char column = 0; column < LCD_COLUMNS; column++)
+        lcdPutChar(row, column, ' ');
+}
+
+void lcdClear()
+{
+    for (unsigned char row = 0; row < LCD_ROWS; row++)
+        lcdClearRow(row);
+}
+
+bool isLcdFlushed()
+{
+    INTCONbits.TMR0IE = 0;
+    bool flushed = lcdSetupIndex == LCD_SETUP_STEPS && lcdDirty[0] == 0 && lcdDirty[1] == 0;
+    INTCONbits.TMR0IE = 1;
+    return flushed;
+}
+
+void handleLcdTick()
+{
+    if (lcdWaitMs > 0)
+    {
+        lcdWaitMs--;
+        return;
+    }
+
+    // U2 and Q1 drive H3 and H4 themselves.  Wait while U2 is pulling H3 low for a carrier, so D4
+    // isn't driven against it.  While Q1 is sampled, leave a tick that is already half over (the
+    // interrupt was held up), so H4 has time to settle before the next conversion.
+    if (IR == 0 || (isSamplingLight() && TMR0 > LCD_LATEST_WRITE_TMR0))
+        return;
+    if (lcdSetupIndex < LCD_SETUP_STEPS)
+    {
+        const struct lcdSetupStep *step = &lcdSetupSteps[lcdSetupIndex++];
+        writeLcd(false, step->command, lcdSetupIndex <= LCD_NIBBLE_STEPS);
+        lcdWaitMs = step->waitMs;
+        return;
+    }
+    if (lcdDirty[0] == 0 && lcdDirty[1] == 0)
+        return;
+
+    // Carry on along a row while its cells have changed, as the module moves on by itself
+    unsigned char row = lcdAddress >= LCD_ROW_2_ADDRESS;
+    unsigned char column = row ? lcdAddress - LCD_ROW_2_ADDRESS : lcdAddress;
+    if (column < LCD_COLUMNS && (lcdDirty[row] & (1u << column)))
+    {
+        lcdDirty[row] &= ~(1u << column);
+        writeLcd(true, lcdScreen[row][column], false);
+        lcdAddress++;
+        return;
+    }
+
+    // Otherwise move to the first changed cell, to write it on the next tick
+    row = lcdDirty[0] == 0;
+    for (column = 0; (lcdDirty[row] & (1u << column)) == 0; column++)
+        ;
+    lcdAddress = row ? LCD_ROW_2_ADDRESS + column : column;
+    writeLcd(false, LCD_SET_ADDRESS | lcdAddress, false);
+}
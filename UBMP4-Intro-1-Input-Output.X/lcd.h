@@ -1,119 +1,70 @@
-// LCD Functions Developed by electroSome
+// The LCD is an HD44780 16x2 character module written in 4-bit mode on the H1-H6 headers: RS on
+// H1, EN on H2 and D4-D7 on H3-H6 (RW is tied low, so the module can only be written).  Callers
+// write characters into a RAM copy of the screen, which costs the main loop almost nothing, and
+// the tick interrupt copies the cells that changed to the module, one write per tick.  Every
+// command except a clear finishes within 37 us, so waiting for the next tick always leaves the
+// module ready and its busy flag never needs to be read.
+//
+// H3-H6 are shared with the IR demodulator (U2), the phototransistor (Q1), LED D3 and LED D4 (and
+// the IR carrier on RC5), so the driver only takes those pins for the few microseconds of each
+// write and then puts them back as they were.  The module ignores its data lines except as EN
+// falls, so the LEDs can carry on using them in between.  U2 and Q1 drive their pins too.  Nothing
+// is written while U2 is receiving a carrier, so D4 isn't driven against it: the changes wait in
+// the RAM copy until the carrier stops.  While the receiver samples Q1, a write only starts early
+// in a tick, once the conversion Timer0 started has finished, so H4 has most of the millisecond
+// to settle before the next conversion.
+
 #define RS H1OUT
 #define EN H2OUT
-#define LD4 H3OUT
-#define LD5 H4OUT
-#define LD6 H5OUT
-#define LD7 H6OUT
 
-void Lcd_Port(char a)
-{
-    if (a & 1)
-        LD4 = 1;
-    else
-        LD4 = 0;
+#define LCD_ROWS 2
+#define LCD_COLUMNS 16
 
-    if (a & 2)
-        LD5 = 1;
-    else
-        LD5 = 0;
+// HD44780 commands
+#define LCD_CLEAR 0x01           // Fill the screen with spaces (takes 1.52 ms)
+#define LCD_ENTRY_INCREMENT 0x06 // Move right after each character, without shifting the screen
+#define LCD_DISPLAY_ON 0x0C      // Display on, cursor and blink off
+#define LCD_4_BIT_2_LINES 0x28   // 4-bit interface, 2 lines, 5x8 dots
+#define LCD_SET_ADDRESS 0x80     // Or'd with the display RAM address to write to next
 
-    if (a & 4)
-        LD6 = 1;
-    else
-        LD6 = 0;
+// The display RAM address of the start of the second row
+#define LCD_ROW_2_ADDRESS 0x40
 
-    if (a & 8)
-        LD7 = 1;
-    else
-        LD7 = 0;
-}
-void Lcd_Cmd(char a)
-{
-    RS = 0; // => RS = 0
-    Lcd_Port(a);
-    EN = 1; // => E = 1
-    __delay_ms(4);
-    EN = 0; // => E = 0
-}
+// The module needs 40 ms after power on before it can be set up
+#define LCD_POWER_ON_MS 50
 
-void Lcd_Clear()
-{
-    Lcd_Cmd(0);
-    Lcd_Cmd(1);
-}
+// The RAM copy of the screen.  Change it with the functions below so the changes get copied.
+extern char lcdScreen[LCD_ROWS][LCD_COLUMNS];
 
-void Lcd_Set_Cursor(char a, char b)
-{
-    char temp, z, y;
-    if (a == 1)
-    {
-        temp = 0x80 + b - 1;
-        z = temp >> 4;
-        y = temp & 0x0F;
-        Lcd_Cmd(z);
-        Lcd_Cmd(y);
-    }
-    else if (a == 2)
-    {
-        temp = 0xC0 + b - 1;
-        z = temp >> 4;
-        y = temp & 0x0F;
-        Lcd_Cmd(z);
-        Lcd_Cmd(y);
-    }
-}
+/**
+ * Take the RS and EN pins and start setting the module up.  The set-up is done by the tick, so
+ * the screen can be written straight away.
+ */
+void initLcd();
 
-void Lcd_Init()
-{
-    Lcd_Port(0x00);
-    __delay_ms(20);
-    Lcd_Cmd(0x03);
-    __delay_ms(5);
-    Lcd_Cmd(0x03);
-    __delay_ms(11);
-    Lcd_Cmd(0x03);
-    /////////////////////////////////////////////////////
-    Lcd_Cmd(0x02);
-    Lcd_Cmd(0x02);
-    Lcd_Cmd(0x08);
-    Lcd_Cmd(0x00);
-    Lcd_Cmd(0x0C);
-    Lcd_Cmd(0x00);
-    Lcd_Cmd(0x06);
-}
+/**
+ * Write a character into the screen at the given row (0-1) and column (0-15).  Only characters
+ * that differ from what is already there are copied to the module.
+ */
+void lcdPutChar(unsigned char row, unsigned char column, char c);
 
-void Lcd_Write_Char(char a)
-{
-    char temp, y;
-    temp = a & 0x0F;
-    y = a & 0xF0;
-    RS = 1;           // => RS = 1
-    Lcd_Port(y >> 4); // Data transfer
-    EN = 1;
-    __delay_us(40);
-    EN = 0;
-    Lcd_Port(temp);
-    EN = 1;
-    __delay_us(40);
-    EN = 0;
-}
+/**
+ * Write text into the screen from the given position, stopping at the end of the row
+ */
+void lcdPutString(unsigned char row, unsigned char column, const char *text);
 
-void Lcd_Write_String(char *a)
-{
-    int i;
-    for (i = 0; a[i] != '\0'; i++)
-        Lcd_Write_Char(a[i]);
-}
+/**
+ * Fill a row, or the whole screen, with spaces
+ */
+void lcdClearRow(unsigned char row);
+void lcdClear();
 
-void Lcd_Shift_Right()
-{
-    Lcd_Cmd(0x01);
-    Lcd_Cmd(0x0C);
-}
+/**
+ * Returns true once every change to the screen has been copied to the module
+ */
+bool isLcdFlushed();
 
-void Lcd_Shift_Left()
-{
-    Lcd_Cmd(0x01);
-    Lcd_Cmd(0x08);
-}
+/**
+ * Copy the next changed cell to the module.  Call from the interrupt handler on every 1 ms tick.
+ */
+void handleLcdTick();
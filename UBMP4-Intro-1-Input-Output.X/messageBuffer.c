@@ -0,0 +1,89 @@
+#include "xc.h"      // Microchip XC8 compiler include file
+#include "stdbool.h" // Include Boolean (true/false) definition
+#include "messageBuffer.h"
+
+// Each byte holds four elements, the first in the lowest 2 bits
+unsigned char messageBuffer[MESSAGE_BUFFER_BYTES];
+unsigned int messageLength = 0;
+unsigned char messageChanges = 0;
+
+// The 2 bit codes, indexed by the code
+const char messageElements[4] = {DOT, DASH, CHAR_SEPARATOR, WORD_SEPARATOR};
+
+unsigned char encodeElement(char element)
+{
+    switch (element)
+    {
+    case DOT:
+        return 0;
+    case DASH:
+        return 1;
+    case CHAR_SEPARATOR:
+        return 2;
+    default:
+        return 3;
+    }
+}
+
+// Store the code for an element at an index that is already part of the message
+void setMessageElement(unsigned int index, char element)
+{
+    unsigned char shift = (unsigned char)((index & 3) << 1);
+    unsigned char *cell = &messageBuffer[index >> 2];
+    *cell = (unsigned char)((*cell & ~(3 << shift)) | (encodeElement(element) << shift));
+    messageChanges++;
+}
+
+void resetMessage()
+{
+    // Stale codes past the end are never read, so there is nothing to clear
+    messageLength = 0;
+    messageChanges++;
+}
+
+bool pushMessageElement(char element)
+{
+    if (messageLength >= MAX_MESSAGE_LENGTH)
+        return false;
+    setMessageElement(messageLength++, element);
+    return true;
+}
+
+void replaceLastMessageElement(char element)
+{
+    if (messageLength > 0)
+        setMessageElement(messageLength - 1, element);
+}
+
+char getMessageElement(unsigned int index)
+{
+    if (index >= messageLength)
+        return EOS;
+    return messageElements[(messageBuffer[index >> 2] >> ((index & 3) << 1)) & 3];
+}
+
+char getLastMessageElement()
+{
+    return messageLength > 0 ? getMessageElement(messageLength - 1) : EOS;
+}
+
+unsigned int getMessageLength()
+{
+    return messageLength;
+}
+
+bool isMessageFull()
+{
+    return messageLength >= MAX_MESSAGE_LENGTH;
+}
+
+void setMessageLength(unsigned int length)
+{
+    messageLength = length < MAX_MESSAGE_LENGTH ? length : MAX_MESSAGE_LENGTH;
+    messageChanges++;
+}
+
+unsigned char getMessageChanges()
+{
+    return messageChanges;
+}
@@ -0,0 +1,64 @@
+// The keyed message is stored packed, 2 bits per element, so the buffer holds four times as
+// many elements as it has bytes.  Elements are pushed onto the end and read back by index.
+
+// The symbols of a message
+#define EOS '\0'
+#define DOT '.'
+#define DASH '-'
+#define CHAR_SEPARATOR ' '
+#define WORD_SEPARATOR '/'
+
+// The size of the packed buffer in bytes and the number of elements it holds (112).  With its
+// element count, that is the longest value the HEF store can save (STORE_MAX_VALUE_BYTES), so a
+// message is always saved whole.
+#define MESSAGE_BUFFER_BYTES 28
+#define MAX_MESSAGE_LENGTH (MESSAGE_BUFFER_BYTES * 4)
+
+/**
+ * Empty the message
+ */
+void resetMessage();
+
+/**
+ * Add an element (DOT, DASH, CHAR_SEPARATOR or WORD_SEPARATOR) to the end of the message.
+ * Returns false if the message is full.
+ */
+bool pushMessageElement(char element);
+
+/**
+ * Replace the last element of the message.  Does nothing if the message is empty.
+ */
+void replaceLastMessageElement(char element);
+
+/**
+ * Returns the element at the given index, or EOS past the end of the message
+ */
+char getMessageElement(unsigned int index);
+
+/**
+ * Returns the last element of the message, or EOS if it is empty
+ */
+char getLastMessageElement();
+
+/**
+ * Returns the number of elements in the message
+ */
+unsigned int getMessageLength();
+
+/**
+ * Returns true when no more elements can be pushed
+ */
+bool isMessageFull();
+
+// The packed message, for saving and restoring it whole
+extern unsigned char messageBuffer[MESSAGE_BUFFER_BYTES];
+
+/**
+ * Make the first length elements of messageBuffer the message
+ */
+void setMessageLength(unsigned int length);
+
+/**
+ * Returns a count that changes whenever the message does
+ */
+unsigned char getMessageChanges();
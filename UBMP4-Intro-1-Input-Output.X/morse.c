@@ -1,8 +1,48 @@
-#include <ctype.h>
-#include <stdlib.h>
-
 #include "morse.h"
 
+/*
+ * Packed Morse codes indexed by ASCII character.  Lower case letters share
+ * the codes of upper case ones.  0 means the character has no code.
+ */
+const unsigned char CHAR_TO_MORSE[128] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* control */
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* control */
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* control */
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* control */
+        0x00, 0x75, 0x52, 0x00, 0x00, 0x00, 0x22, 0x5E, /*   ! " # $ % & ' */
+        0x2D, 0x6D, 0x00, 0x2A, 0x73, 0x61, 0x6A, 0x29, /* ( ) * + , - . / */
+        0x3F, 0x3E, 0x3C, 0x38, 0x30, 0x20, 0x21, 0x23, /* 0 1 2 3 4 5 6 7 */
+        0x27, 0x2F, 0x47, 0x55, 0x00, 0x31, 0x00, 0x4C, /* 8 9 : ; < = > ? */
+        0x56, 0x06, 0x11, 0x15, 0x09, 0x02, 0x14, 0x0B, /* @ A B C D E F G */
+        0x10, 0x04, 0x1E, 0x0D, 0x12, 0x07, 0x05, 0x0F, /* H I J K L M N O */
+        0x16, 0x1B, 0x0A, 0x08, 0x03, 0x0C, 0x18, 0x0E, /* P Q R S T U V W */
+        0x19, 0x1D, 0x13, 0x00, 0x00, 0x00, 0x00, 0x6C, /* X Y Z [ \ ] ^ _ */
+        0x00, 0x06, 0x11, 0x15, 0x09, 0x02, 0x14, 0x0B, /* ` a b c d e f g */
+        0x10, 0x04, 0x1E, 0x0D, 0x12, 0x07, 0x05, 0x0F, /* h i j k l m n o */
+        0x16, 0x1B, 0x0A, 0x08, 0x03, 0x0C, 0x18, 0x0E, /* p q r s t u v w */
+        0x19, 0x1D, 0x13, 0x00, 0x00, 0x00, 0x00, 0x00, /* x y z { | } ~   */
+};
+
+/* Characters indexed by packed Morse code.  0 means the code is unassigned. */
+const char MORSE_TO_CHAR[128] = {
+        0, 0, 'E', 'T', 'I', 'N', 'A', 'M',
+        'S', 'D', 'R', 'G', 'U', 'K', 'W', 'O',
+        'H', 'B', 'L', 'Z', 'F', 'C', 'P', 0,
+        'V', 'X', 0, 'Q', 0, 'Y', 'J', 0,
+        '5', '6', '&', '7', 0, 0, 0, '8',
+        0, '/', '+', 0, 0, '(', 0, '9',
+        '4', '=', 0, 0, 0, 0, 0, 0,
+        '3', 0, 0, 0, '2', 0, '1', '0',
+        0, 0, 0, 0, 0, 0, 0, ':',
+        0, 0, 0, 0, '?', 0, 0, 0,
+        0, 0, '"', 0, 0, ';', '@', 0,
+        0, 0, 0, 0, 0, 0, '\'', 0,
+        0, '-', 0, 0, 0, 0, 0, 0,
+        0, 0, '.', 0, '_', ')', 0, 0,
+        0, 0, 0, ',', 0, '!', 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+};
+
 /* 
  * Function morse_to_index by cypherpunks on Reddit.
  * See: http://goo.gl/amr6A3
@@ -28,15 +68,23 @@ int morse_to_index (const char* str)
         return 0;
 }
 
-const char* char_to_morse (char c)
+unsigned char char_to_code (char c)
 {
-        if (islower(c))
-                c += ('A' - 'a');
+        if ((unsigned char) c >= sizeof(CHAR_TO_MORSE))
+                return MORSE_NO_CODE;
 
-        return CHAR_TO_MORSE[(int) c];
+        return CHAR_TO_MORSE[(unsigned char) c];
 }
 
-const char* morse_to_char (const char* str)
+char code_to_char (unsigned char code)
 {
-        return MORSE_TO_CHAR[morse_to_index(str)];
-}
\ No newline at end of file
+        if (code >= sizeof(MORSE_TO_CHAR))
+                return 0;
+
+        return MORSE_TO_CHAR[code];
+}
+
+char morse_to_char (const char* str)
+{
+        return code_to_char(morse_to_index(str));
+}
@@ -1,108 +1,22 @@
 #ifndef _morse_h
 #define _morse_h
 
-static const char *CHAR_TO_MORSE[128] = {
-    ".----",
-    "..---",
-    "...--",
-    "....-",
-    ".....",
-    "-....",
-    "--...",
-    "---..",
-    "----.",
-    "---...",
-    NULL,
-    NULL,
-    "-...-",
-    NULL,
-    "..--..",
-    ".--.-.",
-    ".-",
-    "-...",
-    "-.-.",
-    "-..",
-    ".",
-    "..-.",
-    "--.",
-    "....",
-    "..",
-    ".---",
-    "-.-",
-    ".-..",
-    "--",
-    "-.",
-    "---",
-    ".--.",
-    "--.-",
-    ".-.",
-    "...",
-    "-",
-    "..-",
-    "...-",
-    ".--",
-    "-..-",
-    "-.--",
-    "--..",
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    "..--.-",
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-};
+/*
+ * Morse codes are packed into one byte the way morse_to_index() builds them:
+ * element i is bit i (1 for a dash, 0 for a dot) and a 1 bit above the last
+ * element marks the length.  So "-.." is 0b1001 and the elements of a code
+ * can be taken off the bottom until only MORSE_CODE_END is left.
+ */
+#define MORSE_NO_CODE 0
+#define MORSE_CODE_END 1
 
-static const char *MORSE_TO_CHAR[128] = {
-    NULL, NULL, "E", "T", "I", "N", "A", "M",
-    "S", "D", "R", "G", "U", "K", "W", "O",
-    "H", "B", "L", "Z", "F", "C", "P", NULL,
-    "V", "X", NULL, "Q", NULL, "Y", "J", NULL,
-    "5", "6", NULL, "7", NULL, NULL, NULL, "8",
-    NULL, "/", NULL, NULL, NULL, "(", NULL, "9",
-    "4", "=", NULL, NULL, NULL, NULL, NULL, NULL,
-    "3", NULL, NULL, NULL, "2", NULL, "1", "0",
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, ":",
-    NULL, NULL, NULL, NULL, "?", NULL, NULL, NULL,
-    NULL, NULL, "\"", NULL, NULL, NULL, "@", NULL,
-    NULL, NULL, NULL, NULL, NULL, NULL, "'", NULL,
-    NULL, "-", NULL, NULL, NULL, NULL, NULL, NULL,
-    NULL, NULL, ".", NULL, "_", ")", NULL, NULL,
-    NULL, NULL, NULL, ",", NULL, "!", NULL, NULL,
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+/* The tables are const so XC8 keeps them in program memory */
+extern const unsigned char CHAR_TO_MORSE[128];
+extern const char MORSE_TO_CHAR[128];
 
-const char *char_to_morse(char);
-const char *morse_to_char(const char *);
+unsigned char char_to_code(char);
+char code_to_char(unsigned char);
+char morse_to_char(const char *);
 int morse_to_index(const char *);
 
 #endif
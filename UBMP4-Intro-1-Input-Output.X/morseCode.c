@@ -13,13 +13,25 @@
 
 //#define USING_INTERRUPTS // Uncomment this to enable the interrupt handling
 
-#include "xc.h"          // Microchip XC8 compiler include file
-#include "stdint.h"      // Include integer definitions
-#include "stdbool.h"     // Include Boolean (true/false) definition
-#include "UBMP4.h"       // Include UBMP4 constants and functions
-#include "convenience.h" // Include convenience utilities
-#include "buzzer.h"      // Include Buzzer utilities
-#include "senderMode.h"  // Include sender mode definitions
+#include "xc.h"            // Microchip XC8 compiler include file
+#include "stddef.h"        // Include NULL definition
+#include "stdint.h"        // Include integer definitions
+#include "stdbool.h"       // Include Boolean (true/false) definition
+#include "UBMP4.h"         // Include UBMP4 constants and functions
+#include "convenience.h"   // Include convenience utilities
+#include "scheduler.h"     // Include the millisecond clock and event scheduler
+#include "buttons.h"       // Include the button event queue
+#include "buzzer.h"        // Include Buzzer utilities
+#include "songPlayer.h"    // Include the background song player
+#include "messageBuffer.h" // Include the packed message buffer
+#include "senderMode.h"    // Include sender mode definitions
+#include "keyer.h"         // Include the keyer and keyed mark timing
+#include "receiverMode.h"  // Include receiver mode definitions
+#include "lcd.h"           // Include the LCD's screen copy
+#include "display.h"       // Include the status and text display
+#include "serial.h"        // Include the serial channel's text queues
+#include "usbCdc.h"        // Include the USB serial port
+#include "settings.h"      // Include the saved settings and message
 
 #define USING_INTERRUPTS 1
 
@@ -31,87 +43,279 @@ enum modeType
 };
 enum modeType currentMode = Diagnostic;
 
-void processMode(enum modeType mode)
+// Set the mode indicator LEDs, leaving alone any LED that is in the middle of a flash
+void setModeIndicators(bool led3, bool led6)
 {
-    // Set mode indicators
-    switch (mode)
+    if (!isEventScheduled(&turnOffLed3))
+        LED3 = led3;
+    if (!isEventScheduled(&turnOffLed6))
+        LED6 = led6;
+}
+
+void processDiagnosticMode(const struct buttonEvent *event)
+{
+    if (!event->pressed && event->button == 2)
+        toggleSongPause();
+    else if (event->pressed && event->button == 3)
     {
-    case Receiver:
-        TURN_ON_LED(6);
-        TURN_OFF_LED(3);
-        break;
-    case Sender:
-        processSenderMode();
-        break;
-    case Diagnostic:
-        TURN_ON_LED(3);
-        TURN_ON_LED(6);
-        if (BUTTON_PRESSED(2) && !BUTTON_PRESSED(5))
-            playTestSounds();
-        else if (BUTTON_PRESSED(3))
-        {
-            FLASH_LED(4, UNIT_LENGTH_MS);
+        FLASH_LED(4, UNIT_LENGTH_MS);
 #ifdef OLD
-            PERIOD_SCALE -= 1;
-            MORSE_CODE_DOT_PERIOD -= 10000;
-            playMorseCodeDotSound();
-            __delay_ms(200);
-            playMorseCodeDashSound();
+        PERIOD_SCALE -= 1;
+        MORSE_CODE_DOT_PERIOD -= 10000;
+        playMorseCodeDotSound();
+        __delay_ms(200);
+        playMorseCodeDashSound();
 #else
-            playChord(cMajor);
+        playChord(cMajor);
 #endif
-        }
-        else if (BUTTON_PRESSED(4))
-        {
-            FLASH_LED(5, UNIT_LENGTH_MS);
+    }
+    else if (event->pressed && event->button == 4)
+    {
+        FLASH_LED(5, UNIT_LENGTH_MS);
 #ifdef OLD
-            PERIOD_SCALE += 1;
-            MORSE_CODE_DOT_PERIOD += 10000;
-            playMorseCodeDotSound();
-            __delay_ms(200);
-            playMorseCodeDashSound();
+        PERIOD_SCALE += 1;
+        MORSE_CODE_DOT_PERIOD += 10000;
+        playMorseCodeDotSound();
+        __delay_ms(200);
+        playMorseCodeDashSound();
 #else
+        if (isSongLoaded())
+            skipSong();
+        else
             playNote(C);
 #endif
-        }
-        else if (BUTTON_PRESSED(5))
-        {
-            FLASH_LED(6, UNIT_LENGTH_MS);
-            EIGHTH_NOTE_DURATION_CYCLES = (EIGHTH_NOTE_DURATION_CYCLES + 100) % 1000;
-        }
-        __delay_ms(200);
-        break;
+    }
+    else if (!event->pressed && event->button == 5)
+    {
+        FLASH_LED(6, UNIT_LENGTH_MS);
+        // Speed up the tempo, going back to the slowest after the fastest.  A playing song
+        // changes speed from its next note.
+        tempoBpm = tempoBpm + TEMPO_STEP_BPM > MAX_TEMPO_BPM ? MIN_TEMPO_BPM : tempoBpm + TEMPO_STEP_BPM;
     }
 }
 
-void checkForModeChange()
+// Set while SW2 and SW5 are held after changing modes, so their releases are ignored
+bool modeChangeHeld = false;
+
+// Returns true if the event was used to change modes
+bool checkForModeChange(const struct buttonEvent *event)
 {
-    if (BUTTON_PRESSED(2) && BUTTON_PRESSED(5))
+    if (event->button != 2 && event->button != 5)
+        return false;
+
+    if (event->pressed && isButtonDown(2) && isButtonDown(5))
     {
         switch (currentMode)
         {
         case Sender:
+            stopTransmitting();
             currentMode = Receiver;
+            startReceiver();
             break;
         case Receiver:
+            stopReceiver();
             currentMode = Diagnostic;
             break;
         case Diagnostic:
+            stopSong();
             currentMode = Sender;
             break;
         }
+        breakText();
+        modeChangeHeld = true;
+        return true;
+    }
 
-        // Add a delay to reduce accidental rapid toggles
-        __delay_ms(200);
+    if (!event->pressed && modeChangeHeld)
+    {
+        if (!isButtonDown(2) && !isButtonDown(5))
+            modeChangeHeld = false;
+        return true;
+    }
+    return false;
+}
+
+// Add the characters the receiver has decoded to the text on the LCD, and send them down the
+// serial channel
+void showReceivedText()
+{
+    char c;
+    while (getReceivedChar(&c))
+    {
+        showChar(c);
+        serialPutChar(c);
+    }
+}
+
+// The text being sent that came from the serial channel.  The sender reads it as it goes, so it
+// is kept apart from the line being read.
+char serialText[SERIAL_LINE_LENGTH + 1];
+
+void replySerial(const char *text)
+{
+    serialPutString(text);
+    serialPutString("\r\n");
+}
+
+// Answer each line that has come in on the serial channel
+void processSerialCommands(enum modeType mode)
+{
+    const char *line;
+    while ((line = getSerialLine()) != NULL)
+    {
+        if (line[0] == '?' && line[1] == EOS)
+        {
+            // Reply with the LCD's status row
+            char status[LCD_COLUMNS + 1];
+            for (unsigned char column = 0; column < LCD_COLUMNS; column++)
+                status[column] = lcdScreen[DISPLAY_STATUS_ROW][column];
+            status[LCD_COLUMNS] = EOS;
+            replySerial(status);
+        }
+        else if (mode == Sender)
+        {
+            unsigned char i = 0;
+            do
+                serialText[i] = line[i];
+            while (line[i++] != EOS);
+            startTransmittingText(serialText);
+            replySerial("OK");
+        }
+        else
+            replySerial("ERR not in sender mode");
     }
 }
 
+// SW1 plays a tone with LED6 on, then resets the PIC if it is still held when the tone ends
+bool resetTonePlaying = false;
+
+void startResetTone()
+{
+    TURN_ON_LED(6);
+    makeSound(400, 900);
+    resetTonePlaying = true;
+}
+
 void checkForReset()
 {
+    if (!resetTonePlaying || isTonePlaying())
+        return;
+    resetTonePlaying = false;
+    TURN_OFF_LED(6);
     if (BUTTON_PRESSED(1))
         RESET();
 }
 
+void processMode(enum modeType mode)
+{
+    // Handle every button edge captured since the last pass
+    struct buttonEvent event;
+    while (getButtonEvent(&event))
+    {
+        if (event.button == 1)
+        {
+            startResetTone();
+            continue;
+        }
+        if (checkForModeChange(&event))
+            return;
+
+        switch (mode)
+        {
+        case Receiver:
+            processReceiverMode(&event);
+            break;
+        case Sender:
+            processSenderMode(&event);
+            break;
+        case Diagnostic:
+            processDiagnosticMode(&event);
+            break;
+        }
+    }
+
+    switch (mode)
+    {
+    case Receiver:
+        setModeIndicators(false, true);
+        decodeReceivedSignal();
+        showStatus("RX", WPM_UNIT_LENGTH_MS / receiverUnitMs, "WPM");
+        showReceivedText();
+        break;
+    case Sender:
+        setModeIndicators(true, false);
+        showStatus(senderStatusName(), senderWpm(), "WPM");
+        break;
+    case Diagnostic:
+        setModeIndicators(true, true);
+        showStatus("DIAG", tempoBpm, "BPM");
+        break;
+    }
+    processSerialCommands(mode);
+}
+
+// Returns true when the CPU stopping for a flash write couldn't spoil anything being timed
+bool isIdle()
+{
+    for (unsigned char button = 2; button <= 5; button++)
+        if (isButtonDown(button))
+            return false;
+    if (currentSenderState == Transmitting || isTonePlaying() || (isSongLoaded() && !isSongPaused()))
+        return false;
+    return currentMode != Receiver || isReceiverIdle();
+}
+
+// How long everything must stay idle before the PIC sleeps.  Much longer than any gap the keyer
+// or the receiver times, so the millis() that stop while asleep can only make a gap that was
+// already a word gap look shorter.
+#define IDLE_SLEEP_MS 2000
+
+unsigned int lastBusyMs = 0;
+
+// Sleep once nothing has happened for IDLE_SLEEP_MS, until a button changes or, in Receiver mode
+// with the IR input, a carrier starts.  The light sensor needs the tick, so it can't wake the PIC.
+void sleepWhenIdle()
+{
+    bool infrared = currentMode == Receiver && currentReceiverSource == InfraredInput;
+    if (!isIdle() || !isSchedulerIdle() || !isLcdFlushed() || isSettingsSavePending(currentMode) ||
+        (currentMode == Receiver && !infrared))
+    {
+        lastBusyMs = millis();
+        return;
+    }
+    if ((unsigned int)(millis() - lastBusyMs) < IDLE_SLEEP_MS)
+        return;
+
+    // The wake-up sources that the interrupt handler doesn't know about must be turned off again
+    // before it can run
+    bool woken = false;
+    INTCONbits.GIE = 0;
+    if (prepareUsbCdcForSleep())
+    {
+        // The LEDs would draw far more than the sleeping PIC.  The mode indicators come back
+        // on the next pass.
+        LATC &= 0b00001111;
+        RUNLED = 1;
+        if (infrared)
+            IR_wake_enable();
+        OSC_sleep();
+        RUNLED = 0;
+        if (infrared)
+        {
+            woken = PIR2bits.C2IF;
+            IR_wake_disable();
+        }
+        if (resumeUsbCdc())
+            woken = true;
+    }
+    INTCONbits.GIE = 1;
+
+    // A button wakes the PIC into a busy state, but a carrier or a computer needs time to be
+    // noticed by the receiver or the USB driver, so wait as long again before sleeping
+    if (woken)
+        lastBusyMs = millis();
+}
+
 #if USING_INTERRUPTS
 void setupInterrupts()
 {
@@ -121,40 +325,79 @@ void setupInterrupts()
 }
 void __interrupt() isr()
 {
+    if (INTCONbits.TMR0IF == 1)
+    {
+        handleTickInterrupt();
+        handleToneTick();
+        handleKeyingTick();
+        checkButtonLevels();
+        sampleReceiverInput();
+        handleLcdTick();
+    }
     if (INTCONbits.IOCIF == 1)
     {
         INTCONbits.IOCIF = 0;
+        if (IOCBF & BUTTON_PINS)
+            handleButtonInterrupt();
         if (SW1_INTERRUPT_FLAG == 1)
-        {
-            SW1_INTERRUPT_FLAG = 0;
-            FLASH_LED(6, 100);
-            makeSound(400, 300);
-            checkForReset();
-        }
+            handleResetButtonInterrupt();
     }
+    if (PIR1bits.TMR1IF == 1)
+        handleToneInterrupt();
+    if (PIE1bits.ADIE == 1 && PIR1bits.ADIF == 1)
+        ADC_sample_isr();
 }
 #endif
-// TODO Set linker ROM ranges to 'default,-0-7FF' under "Memory model" pull-down.
+// TODO Set linker ROM ranges to 'default,-0-7FF,-1F80-1FFF' under "Memory model" pull-down.
+// (The last 128 words are the high-endurance flash used by storage.c.)
 // TODO Set linker code offset to '800' under "Additional options" pull-down.
 
-// This is the entry point for the program
-int main(void)
+// Configure oscillator and I/O ports. This runs once at start-up.
+void setupMorseCode()
 {
-    // Configure oscillator and I/O ports. These functions run once at start-up.
-    OSC_config();   // Configure internal oscillator for 48 MHz
-    UBMP4_config(); // Configure on-board UBMP4 I/O devices
+    OSC_config();        // Configure internal oscillator for 48 MHz
+    UBMP4_config();      // Configure on-board UBMP4 I/O devices
+    initScheduler();     // Configure the millisecond tick
+    initTone();          // Configure the buzzer's tone generator
+    IR_carrier_config(); // Configure the IR LED's 38 kHz carrier
+    initLcd();           // Start setting up the LCD
+    initButtons();       // Capture SW2-SW5 by interrupt-on-change
+    initUsbCdc();        // Attach to USB as a serial port
+
+    // Carry on in the mode and with the settings and message from before the reset
+    currentMode = restoreSettings(Diagnostic);
+    if (currentMode > Diagnostic)
+        currentMode = Diagnostic;
+    if (currentMode == Receiver)
+        startReceiver();
 
 #if USING_INTERRUPTS
     setupInterrupts();
 #endif
+}
+
+// One pass of the main loop.  Nothing in it may block: anything that has to happen later is a
+// scheduled event dispatched here.
+void runMorseCode()
+{
+    runScheduledEvents();
+    serviceUsbCdc();
+    processMode(currentMode);
+    saveSettingsWhenIdle(currentMode, isIdle());
+    sleepWhenIdle();
+    checkForReset();
+}
 
-    resetMessage();
+// The host build (see host/) provides its own entry point that runs the two functions above
+// against simulated hardware
+#ifndef HOST_BUILD
+// This is the entry point for the program
+int main(void)
+{
+    setupMorseCode();
 
-    // Code in this while loop runs repeatedly.
+    // Code in this while loop runs repeatedly
     while (1)
-    {
-        processMode(currentMode);
-        checkForModeChange();
-        checkForReset();
-    }
+        runMorseCode();
 }
+#endif
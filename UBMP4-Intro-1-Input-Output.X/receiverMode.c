@@ -0,0 +1,364 @@
+#include "xc.h"          // Microchip XC8 compiler include file
+#include "stddef.h"      // Include NULL definition
+#include "stdbool.h"     // Include Boolean (true/false) definition
+#include "UBMP4.h"       // Include UBMP4 constants and functions
+#include "convenience.h" // Include convenience utilities
+#include "scheduler.h"
+#include "buttons.h"
+#include "buzzer.h"
+#include "messageBuffer.h"
+#include "senderMode.h"
+#include "keyer.h"
+#include "morse.h"
+#include "receiverMode.h"
+#include "display.h"
+
+enum receiverSource currentReceiverSource = InfraredInput;
+unsigned int receiverUnitMs = UNIT_LENGTH_MS;
+
+struct receiverEdge
+{
+    bool mark;         // true when a mark starts, false when it ends
+    unsigned int time; // millis() when the edge happened
+};
+struct receiverEdge receiverEdges[RECEIVER_EDGE_QUEUE_SIZE];
+volatile unsigned char receiverEdgeHead = 0; // Only written by the interrupt
+volatile unsigned char receiverEdgeTail = 0; // Only written by the main loop
+
+// The filtered view of the input
+volatile bool receiverEnabled = false;
+bool receiverLevel = false;
+unsigned char receiverStableCount = 0;
+
+// The light input's smoothed brightness and envelopes, which start from the first sample so the
+// ambient light doesn't look like a signal while they settle
+unsigned int lightLevel;
+unsigned int lightHigh;
+unsigned int lightLow;
+bool lightSeeded;
+
+// The main loop's decoding state
+bool markActive = false;
+unsigned int lastEdgeTime;
+// The elements of the letter being received, packed as in morse.h but without the length bit
+unsigned char symbolBits = 0;
+unsigned char symbolLength = 0;
+bool wordPending = false;
+
+// The unit is seeded from the shortest of the first mark, the space after it and the next mark,
+// which is one unit long unless the first two marks are dashes in different letters.  Until
+// then their lengths are held here and decoded once the unit is known.
+// RECEIVER_SEED_LENGTHS means the unit is seeded.
+unsigned int seedLengths[RECEIVER_SEED_LENGTHS];
+unsigned char seedCount = 0;
+
+char receivedText[RECEIVED_TEXT_QUEUE_SIZE];
+unsigned char receivedTextHead = 0;
+unsigned char receivedTextTail = 0;
+
+void startReceiver()
+{
+    receiverLevel = false;
+    receiverStableCount = 0;
+    receiverEdgeTail = receiverEdgeHead;
+    markActive = false;
+    lastEdgeTime = millis();
+    symbolBits = 0;
+    symbolLength = 0;
+    wordPending = false;
+    seedCount = 0;
+    if (currentReceiverSource == LightInput)
+    {
+        lightSeeded = false;
+        // Set up Q1's pin and the ADC without ADC_config(), which would clear the LEDs' and the
+        // LCD's latches
+        TRISCbits.TRISC3 = 1;      // Q1's pin is an input
+        ANSELCbits.ANSC3 = 1;      // and an analogue one
+        ADCON1 = 0b01100000;       // Left justified result, FOSC/64 clock, +VDD ref
+        ADCON2 = ADC_TRIGGER_NONE; // Until ADC_start_sampling() sets the trigger
+        ADC_start_sampling(ANQ1);
+    }
+    receiverEnabled = true;
+}
+
+void stopReceiver()
+{
+    receiverEnabled = false;
+    ADC_stop_sampling();
+    ANSELCbits.ANSC3 = 0;
+    stopTone();
+    TURN_OFF_LED(4);
+}
+
+// Queue an edge once the input has been at a new level for RECEIVER_GLITCH_MS samples.  Each
+// input is only filtered by one side: the IR input by the interrupt, the light input by the main loop.
+void filterReceiverLevel(bool level, unsigned int time)
+{
+    if (level == receiverLevel)
+    {
+        receiverStableCount = 0;
+        return;
+    }
+    if (++receiverStableCount < RECEIVER_GLITCH_MS)
+        return;
+
+    // The input has been steady long enough, so it changed when it first moved
+    receiverStableCount = 0;
+    receiverLevel = level;
+    unsigned char next = (receiverEdgeHead + 1) & (RECEIVER_EDGE_QUEUE_SIZE - 1);
+    if (next == receiverEdgeTail)
+        return; // The buffer is full, so this edge is lost
+    receiverEdges[receiverEdgeHead].mark = level;
+    receiverEdges[receiverEdgeHead].time = time - (RECEIVER_GLITCH_MS - 1);
+    receiverEdgeHead = next;
+}
+
+bool isSamplingLight()
+{
+    return receiverEnabled && currentReceiverSource == LightInput;
+}
+
+void sampleReceiverInput()
+{
+    if (receiverEnabled && currentReceiverSource == InfraredInput)
+        filterReceiverLevel(IR == 0, millis());
+}
+
+// Turn a light sample into a mark or space.  The brightness is smoothed, and the brightest and
+// darkest levels are tracked by envelopes that jump to new extremes and relax slowly towards the
+// current level, so the threshold half way between them follows the ambient light.
+bool detectLightMark(unsigned char sample)
+{
+    // Q1 pulls its input low when lit, so invert the sample to get the brightness
+    unsigned char brightness = 255 - sample;
+    if (!lightSeeded)
+    {
+        lightLevel = brightness << 2;
+        lightHigh = lightLow = lightLevel << 6;
+        lightSeeded = true;
+    }
+
+    // lightLevel holds 4 times the moving average of the last few samples
+    lightLevel += brightness - (lightLevel >> 2);
+
+    // The envelopes are 8.8 fixed point
+    unsigned int level = lightLevel << 6;
+    if (level > lightHigh)
+        lightHigh = level;
+    else
+        lightHigh -= (lightHigh - level) >> LIGHT_ENVELOPE_DECAY_SHIFT;
+    if (level < lightLow)
+        lightLow = level;
+    else
+        lightLow += (level - lightLow) >> LIGHT_ENVELOPE_DECAY_SHIFT;
+
+    unsigned int contrast = lightHigh - lightLow;
+    if (contrast < (MIN_LIGHT_CONTRAST << 8))
+        return false; // Only ambient light, no signal
+
+    // Only change state once the level is clearly past the threshold
+    unsigned int threshold = lightLow + (contrast >> 1);
+    unsigned int hysteresis = contrast >> LIGHT_HYSTERESIS_SHIFT;
+    if (receiverLevel)
+        return level > threshold - hysteresis;
+    return level > threshold + hysteresis;
+}
+
+void processLightSamples()
+{
+    unsigned int time;
+    unsigned char *samples = ADC_take_sample_block(&time);
+    if (samples == NULL)
+        return;
+
+    // The samples are 1 ms apart and the last one was taken at time
+    time -= ADC_BLOCK_SIZE - 1;
+    for (unsigned char i = 0; i < ADC_BLOCK_SIZE; i++)
+        filterReceiverLevel(detectLightMark(samples[i]), time++);
+}
+
+bool getReceiverEdge(struct receiverEdge *edge)
+{
+    if (receiverEdgeTail == receiverEdgeHead)
+        return false;
+    *edge = receiverEdges[receiverEdgeTail];
+    receiverEdgeTail = (receiverEdgeTail + 1) & (RECEIVER_EDGE_QUEUE_SIZE - 1);
+    return true;
+}
+
+void pushReceivedChar(char c)
+{
+    unsigned char next = (receivedTextHead + 1) & (RECEIVED_TEXT_QUEUE_SIZE - 1);
+    if (next == receivedTextTail)
+        return; // Nobody is reading the text, so drop it
+    receivedText[receivedTextHead] = c;
+    receivedTextHead = next;
+}
+
+bool getReceivedChar(char *c)
+{
+    if (receivedTextTail == receivedTextHead)
+        return false;
+    *c = receivedText[receivedTextTail];
+    receivedTextTail = (receivedTextTail + 1) & (RECEIVED_TEXT_QUEUE_SIZE - 1);
+    return true;
+}
+
+// Like the keyer's adaptUnitLength(), but down to the fast infrared speed rather than the
+// fastest an operator can key
+void adaptReceiverUnit(unsigned int measuredUnitMs)
+{
+    receiverUnitMs = (receiverUnitMs + measuredUnitMs) / 2;
+    if (receiverUnitMs < MIN_RECEIVER_UNIT_MS)
+        receiverUnitMs = MIN_RECEIVER_UNIT_MS;
+    else if (receiverUnitMs > MAX_KEYER_UNIT_MS)
+        receiverUnitMs = MAX_KEYER_UNIT_MS;
+}
+
+void decodeSymbol()
+{
+    char decoded = code_to_char(symbolBits | (1 << symbolLength));
+    pushReceivedChar(decoded != 0 ? decoded : '?');
+    symbolBits = 0;
+    symbolLength = 0;
+    clearElements();
+    wordPending = true;
+    FLASH_LED(5, UNIT_LENGTH_MS);
+}
+
+// A space just ended.  Gaps inside a letter are one unit long; longer ones end the letter.
+void decodeSpace(unsigned int length)
+{
+    if (symbolLength > 0 && length < receiverUnitMs * 2)
+        adaptReceiverUnit(length);
+    else if (symbolLength > 0)
+        decodeSymbol();
+}
+
+// A mark just ended: shorter than 2 units is a dot (1 unit), longer is a dash (3 units)
+void decodeMark(unsigned int length)
+{
+    if (length > receiverUnitMs * MAX_MARK_UNITS)
+        return;
+    if (symbolLength == MAX_SYMBOL_LENGTH)
+        decodeSymbol(); // Too long to be a letter, so give up on it
+    if (length < receiverUnitMs * 2)
+    {
+        symbolLength++;
+        adaptReceiverUnit(length);
+        showElement(DOT);
+    }
+    else
+    {
+        symbolBits |= 1 << symbolLength++;
+        adaptReceiverUnit(length / 3);
+        showElement(DASH);
+    }
+}
+
+// Decode the marks and space held while seeding, with the unit they give
+void decodeSeedLengths()
+{
+    unsigned int unitMs = seedLengths[0];
+    for (unsigned char i = 1; i < seedCount; i++)
+        if (seedLengths[i] < unitMs)
+            unitMs = seedLengths[i];
+    receiverUnitMs = unitMs;
+    adaptReceiverUnit(unitMs); // Only keeps it in range
+    for (unsigned char i = 0; i < seedCount; i++)
+    {
+        if (i & 1)
+            decodeSpace(seedLengths[i]);
+        else
+            decodeMark(seedLengths[i]);
+    }
+    seedCount = RECEIVER_SEED_LENGTHS;
+}
+
+void decodeReceivedSignal()
+{
+    if (currentReceiverSource == LightInput)
+        processLightSamples();
+
+    struct receiverEdge edge;
+    while (getReceiverEdge(&edge))
+    {
+        unsigned int length = edge.time - lastEdgeTime;
+        lastEdgeTime = edge.time;
+        markActive = edge.mark;
+        if (edge.mark)
+        {
+            startMorseCodeTone();
+            TURN_ON_LED(4);
+        }
+        else
+        {
+            stopTone();
+            TURN_OFF_LED(4);
+        }
+
+        // The space before the first mark says nothing about the unit
+        if (seedCount < RECEIVER_SEED_LENGTHS && (seedCount > 0 || !edge.mark))
+        {
+            seedLengths[seedCount++] = length;
+            if (seedCount == RECEIVER_SEED_LENGTHS)
+                decodeSeedLengths();
+        }
+        else if (seedCount == RECEIVER_SEED_LENGTHS && edge.mark)
+            decodeSpace(length);
+        else if (seedCount == RECEIVER_SEED_LENGTHS)
+            decodeMark(length);
+    }
+
+    if (!markActive)
+    {
+        unsigned int space = millis() - lastEdgeTime;
+
+        // A lone mark followed by a long silence is all there is to seed from, so decode it with
+        // the unit as it was
+        if (seedCount == 1 && space / RECEIVER_IDLE_UNITS >= seedLengths[0])
+            decodeSeedLengths();
+        if (seedCount < RECEIVER_SEED_LENGTHS)
+            return;
+
+        // Finish the letter (after 2 units) and the word (after 5 units) once the space is long
+        // enough.  Once the receiver is idle the next sender may be at another speed, so the unit
+        // is seeded again.
+        if (symbolLength > 0 && space >= receiverUnitMs * 2)
+            decodeSymbol();
+        if (wordPending && space >= receiverUnitMs * 5)
+        {
+            pushReceivedChar(' ');
+            wordPending = false;
+        }
+        if (!wordPending && space >= receiverUnitMs * RECEIVER_IDLE_UNITS)
+            seedCount = 0;
+    }
+}
+
+void processReceiverMode(const struct buttonEvent *event)
+{
+    if (event->pressed && event->button == 3)
+    {
+        // Switch inputs: one beep for IR, two for light
+        stopReceiver();
+        if (currentReceiverSource == InfraredInput)
+        {
+            currentReceiverSource = LightInput;
+            makeMultipleSound(500, 300, 2);
+        }
+        else
+        {
+            currentReceiverSource = InfraredInput;
+            makeMultipleSound(500, 300, 1);
+        }
+        startReceiver();
+    }
+}
+
+bool isReceiverIdle()
+{
+    return !markActive && symbolLength == 0 && !wordPending &&
+           (seedCount == 0 || seedCount == RECEIVER_SEED_LENGTHS) &&
+           (unsigned int)(millis() - lastEdgeTime) >= receiverUnitMs * RECEIVER_IDLE_UNITS;
+}
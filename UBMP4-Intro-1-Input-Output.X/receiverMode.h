@@ -0,0 +1,87 @@
+// The receiver decodes Morse code from the IR demodulator (U2) or the light sensor (Q1).  The tick
+// interrupt samples the IR input every millisecond and queues the time of each filtered edge, so no
+// edge is missed while the main loop is busy.  The light sensor is converted by the ADC on every
+// tick and the main loop finds the edges in each block of samples, using a threshold that follows
+// the ambient light.  The main loop turns the mark and space lengths into
+// elements (adapting to the sender's speed like the straight key does) and decodes each letter.
+
+// Input changes that don't last this long are ignored as noise
+#define RECEIVER_GLITCH_MS 4
+
+// The light envelopes relax towards the current level by 1/256 of the difference per sample
+// (a time constant of about 256 ms)
+#define LIGHT_ENVELOPE_DECAY_SHIFT 8
+
+// The light input needs at least this much difference between light and dark (out of 255) to
+// be a signal, and must cross the threshold by 1/8 of that difference to change state
+#define MIN_LIGHT_CONTRAST 12
+#define LIGHT_HYSTERESIS_SHIFT 3
+
+// The shortest unit the receiver adapts to: the sender's fast infrared speed, which is more than
+// twice the glitch filter
+#define MIN_RECEIVER_UNIT_MS FAST_INFRARED_UNIT_MS
+
+// Marks longer than this many units aren't Morse code (e.g. a steady light)
+#define MAX_MARK_UNITS 7
+
+// The unit is seeded from this many lengths at the start of each transmission: the first mark,
+// the space after it and the next mark
+#define RECEIVER_SEED_LENGTHS 3
+
+// The longest symbol MORSE_TO_CHAR can decode
+#define MAX_SYMBOL_LENGTH 6
+
+// The receiver counts as idle once the input has been quiet for this many units after the last
+// word (two word gaps)
+#define RECEIVER_IDLE_UNITS 14
+
+// The sizes of the edge and decoded text ring buffers.  Must be powers of 2.
+#define RECEIVER_EDGE_QUEUE_SIZE 16
+#define RECEIVED_TEXT_QUEUE_SIZE 32
+
+enum receiverSource
+{
+    InfraredInput, // IR demodulator U2 (RC2), low while a 38 kHz carrier is received
+    LightInput     // Phototransistor Q1 (AN7), lower readings when lit
+};
+extern enum receiverSource currentReceiverSource;
+
+// The receiver's current estimate of the sender's unit length
+extern unsigned int receiverUnitMs;
+
+/**
+ * Start or stop sampling the receiver input
+ */
+void startReceiver();
+void stopReceiver();
+
+/**
+ * Returns true while the receiver is sampling the light input.  Q1 shares H4 with the LCD's D5,
+ * so the LCD only writes early in each tick while it is.
+ */
+bool isSamplingLight();
+
+/**
+ * Sample the receiver input.  Call from the interrupt handler on each tick.
+ */
+void sampleReceiverInput();
+
+/**
+ * Decode the edges received since the last call.  Call on every pass of the main loop while in Receiver mode.
+ */
+void decodeReceivedSignal();
+
+/**
+ * Handle a button event in Receiver mode (SW3 switches between the IR and light inputs)
+ */
+void processReceiverMode(const struct buttonEvent *event);
+
+/**
+ * Take the oldest decoded character.  Returns false when there are none.
+ */
+bool getReceivedChar(char *c);
+
+/**
+ * Returns true when nothing is being received, so missing a few samples would do no harm
+ */
+bool isReceiverIdle();
@@ -0,0 +1,128 @@
+#include "xc.h"          // Microchip XC8 compiler include file
+#include "stddef.h"      // Include NULL definition
+#include "stdbool.h"     // Include Boolean (true/false) definition
+#include "UBMP4.h"       // Include UBMP4 constants and functions
+#include "convenience.h" // Include convenience utilities
+#include "scheduler.h"
+
+volatile unsigned int tickCount = 0;
+// The next tick's reload, and the cycles left over from rounding it to whole counts
+unsigned char nextTickReload = 256 - TICK_CYCLES_PER_MS / TICK_CYCLES_PER_COUNT;
+unsigned char tickCyclesCarried = 0;
+
+struct scheduledEvent
+{
+    fScheduledEvent action; // NULL when the slot is free
+    unsigned int dueTime;
+};
+struct scheduledEvent events[MAX_SCHEDULED_EVENTS];
+
+void initScheduler()
+{
+    OPTION_REG = (OPTION_REG & 0b11110000) | 0b00000101; // TMR0 internal, prescaler assigned, div-64
+    TMR0 = nextTickReload;
+    INTCONbits.TMR0IF = 0;
+    INTCONbits.TMR0IE = 1;
+}
+
+void handleTickInterrupt()
+{
+    // Add (rather than load) the reload value so counts that passed before we got here aren't lost.
+    // This comes first so the cycles the write loses are as few, and as steady, as they can be.
+    TMR0 += nextTickReload;
+    INTCONbits.TMR0IF = 0;
+    tickCount++;
+
+    // Make the next tick 1 ms less the cycles the write loses, in whole counts, carrying the rest
+    // over so the ticks average out to 1 ms.  A tick held up by another interrupt, or while
+    // TMR0IE is clear, loses up to another count.
+    unsigned int cycles = tickCyclesCarried + TICK_CYCLES_PER_MS - TMR0_WRITE_LOST_CYCLES;
+    nextTickReload = (unsigned char)(256 - cycles / TICK_CYCLES_PER_COUNT);
+    tickCyclesCarried = cycles % TICK_CYCLES_PER_COUNT;
+}
+
+unsigned int millis()
+{
+    // A 16-bit read takes two instructions, so keep the tick from changing it half way through
+    INTCONbits.TMR0IE = 0;
+    unsigned int now = tickCount;
+    INTCONbits.TMR0IE = 1;
+    return now;
+}
+
+bool scheduleEvent(unsigned int delayMs, fScheduledEvent action)
+{
+    unsigned int dueTime = millis() + delayMs;
+    signed char freeSlot = -1;
+    for (unsigned char i = 0; i < MAX_SCHEDULED_EVENTS; i++)
+    {
+        if (events[i].action == action)
+        {
+            events[i].dueTime = dueTime;
+            return true;
+        }
+        if (events[i].action == NULL && freeSlot < 0)
+            freeSlot = i;
+    }
+    if (freeSlot < 0)
+        return false;
+    events[freeSlot].dueTime = dueTime;
+    events[freeSlot].action = action;
+    return true;
+}
+
+void cancelEvent(fScheduledEvent action)
+{
+    for (unsigned char i = 0; i < MAX_SCHEDULED_EVENTS; i++)
+        if (events[i].action == action)
+            events[i].action = NULL;
+}
+
+bool isEventScheduled(fScheduledEvent action)
+{
+    for (unsigned char i = 0; i < MAX_SCHEDULED_EVENTS; i++)
+        if (events[i].action == action)
+            return true;
+    return false;
+}
+
+bool isSchedulerIdle()
+{
+    for (unsigned char i = 0; i < MAX_SCHEDULED_EVENTS; i++)
+        if (events[i].action != NULL)
+            return false;
+    return true;
+}
+
+void runScheduledEvents()
+{
+    unsigned int now = millis();
+    for (unsigned char i = 0; i < MAX_SCHEDULED_EVENTS; i++)
+    {
+        fScheduledEvent action = events[i].action;
+        // Compare the difference so the clock wrapping around doesn't matter
+        if (action != NULL && (int)(now - events[i].dueTime) >= 0)
+        {
+            // Free the slot first so the action can schedule itself again
+            events[i].action = NULL;
+            (*action)();
+        }
+    }
+}
+
+void turnOffLed3()
+{
+    TURN_OFF_LED(3);
+}
+void turnOffLed4()
+{
+    TURN_OFF_LED(4);
+}
+void turnOffLed5()
+{
+    TURN_OFF_LED(5);
+}
+void turnOffLed6()
+{
+    TURN_OFF_LED(6);
+}
@@ -0,0 +1,71 @@
+// The scheduler keeps a millisecond clock (driven by the Timer0 interrupt) and a small queue of
+// events that the main loop dispatches when they fall due.  Use it instead of __delay_ms() so the
+// main loop never stops polling the buttons.
+
+// Timer0 runs from Fosc/4 with a 1:64 prescaler, so 187.5 counts make up one millisecond.
+#define TICK_CYCLES_PER_MS 12000
+#define TICK_CYCLES_PER_COUNT 64
+#define TICK_COUNTS_PER_MS_HIGH 188
+
+// Writing TMR0 clears the prescaler, losing the cycles it had counted towards the next count, and
+// holds Timer0 for 2 cycles, so every reload makes the tick longer by this many cycles.  The
+// prescaler had counted the cycles from the overflow to the write: 3-5 of interrupt latency, the
+// handler's entry, the TMR0IF test and the call, about 14 in all.  This is an estimate of the
+// instructions XC8 generates, so check it in the listing if the code in front of the write changes.
+#define TMR0_WRITE_LOST_CYCLES 16
+
+// The number of events that can be waiting at the same time
+#define MAX_SCHEDULED_EVENTS 8
+
+// This is the definition of a function pointer type for the actions run by scheduled events.
+typedef void (*fScheduledEvent)(void);
+
+/**
+ * Configure Timer0 for a 1 ms tick.  Call once at start-up, before enabling interrupts.
+ */
+void initScheduler();
+
+/**
+ * Service the tick timer.  Call from the interrupt handler when the Timer0 flag is set.
+ */
+void handleTickInterrupt();
+
+/**
+ * Returns the number of milliseconds since start-up.  This wraps every 65.5 s, so only compare
+ * times by subtracting them.
+ */
+unsigned int millis();
+
+/**
+ * Run the action after delayMs milliseconds.  An action is only queued once: scheduling an action
+ * that is already waiting moves it to the new time.  Only call this from the main loop.
+ *
+ * Returns false when the queue is full.
+ */
+bool scheduleEvent(unsigned int delayMs, fScheduledEvent action);
+
+/**
+ * Remove the action from the queue if it is waiting
+ */
+void cancelEvent(fScheduledEvent action);
+
+/**
+ * Returns true while the action is waiting to run
+ */
+bool isEventScheduled(fScheduledEvent action);
+
+/**
+ * Returns true when no events are waiting
+ */
+bool isSchedulerIdle();
+
+/**
+ * Run every event that has fallen due.  Call this on every pass of the main loop.
+ */
+void runScheduledEvents();
+
+// Scheduled actions used by the FLASH_LED macros in convenience.h
+void turnOffLed3();
+void turnOffLed4();
+void turnOffLed5();
+void turnOffLed6();
@@ -1,137 +1,332 @@
 #include "xc.h"          // Microchip XC8 compiler include file
+#include "stdbool.h"     // Include Boolean (true/false) definition
+#include "stddef.h"      // Include NULL definition
 #include "UBMP4.h"       // Include UBMP4 constants and functions
 #include "convenience.h" // Include convenience utilities
+#include "scheduler.h"
+#include "buttons.h"
 #include "buzzer.h"
+#include "messageBuffer.h"
 #include "senderMode.h"
+#include "keyer.h"
+#include "morse.h"
+#include "display.h"
+
+// The index of the next element of the keyed message to transmit
+unsigned int currentMessageIndex = 0;
+enum senderState currentSenderState = AcceptingInput;
+
+// The unit length the message is being sent at, taken from the keyer when sending starts
+unsigned int transmitUnitMs = UNIT_LENGTH_MS;
+bool fastInfraredMode = false;
+
+// The elements of a message are transmitted by a chain of scheduled events, one per element.
+// The tick ends each mark (see startKeyedMark()) and the next element follows a one unit gap.
+void transmitNextElement();
 
 void transmitDot()
 {
-    TURN_ON_LED(4);
-    __delay_ms(UNIT_LENGTH_MS);
-    TURN_OFF_LED(4);
+    startKeyedMark(transmitUnitMs);
+    scheduleEvent(transmitUnitMs * (1 + ELEMENT_GAP_UNITS), &transmitNextElement);
 }
 void transmitDash()
 {
-    TURN_ON_LED(4);
-    __delay_ms(UNIT_LENGTH_MS * 3);
-    TURN_OFF_LED(4);
+    startKeyedMark(transmitUnitMs * 3);
+    scheduleEvent(transmitUnitMs * (3 + ELEMENT_GAP_UNITS), &transmitNextElement);
 }
+// A separator always follows an element, whose gap is already part of the letter or word gap, so
+// it only adds the rest.  Nothing else may be scheduled before the next element, or the gap grows.
 void transmitCharSeparator()
 {
-    __delay_ms(UNIT_LENGTH_MS);
+    scheduleEvent(transmitUnitMs * (LETTER_GAP_UNITS - ELEMENT_GAP_UNITS), &transmitNextElement);
 }
 void transmitWordSeparator()
 {
-    __delay_ms(UNIT_LENGTH_MS * 2);
+    scheduleEvent(transmitUnitMs * (WORD_GAP_UNITS - ELEMENT_GAP_UNITS), &transmitNextElement);
 }
-void resetMessage()
+
+// Canned text messages that can be sent instead of the keyed one.  They stay in flash and are
+// encoded one character at a time as they are sent.
+const char *const textMessages[] = {
+    "SOS",
+    "CQ CQ DE UBMP4",
+    "HELLO WORLD",
+};
+#define TEXT_MESSAGE_COUNT (sizeof(textMessages) / sizeof(textMessages[0]))
+
+// The text being sent, or NULL when sending the keyed message
+const char *transmitText = NULL;
+unsigned char transmitTextIndex = 0;
+// The elements of the current character that are still to be sent, packed as in morse.h
+unsigned char transmitCode = MORSE_CODE_END;
+// Set once a character has been sent, so the next one is preceded by a character gap
+bool transmitNeedsSeparator = false;
+
+char nextMessageElement()
 {
-    currentMessageIndex = 0;
-    for (int i; i < MAX_MESSAGE_LENGTH; i++)
-        message[i] = EOS;
+    // Repeat the message from the beginning once we reach its end
+    if (currentMessageIndex >= getMessageLength())
+        currentMessageIndex = 0;
+    return getMessageElement(currentMessageIndex++);
 }
-void transmitMessage()
+// Take the next element off the packed code of the current character
+char takeCodeElement()
+{
+    char element = (transmitCode & 1) ? DASH : DOT;
+    transmitCode >>= 1;
+    return element;
+}
+char nextTextElement()
+{
+    if (transmitCode > MORSE_CODE_END)
+        return takeCodeElement();
+
+    // The current character is finished, so look at the next one
+    char c = transmitText[transmitTextIndex];
+    if (c == EOS || c == ' ')
+    {
+        // The end of a word.  The text is repeated after a word gap once we reach its end.
+        transmitTextIndex = c == EOS ? 0 : transmitTextIndex + 1;
+        transmitNeedsSeparator = false;
+        return WORD_SEPARATOR;
+    }
+    if (transmitNeedsSeparator)
+    {
+        transmitNeedsSeparator = false;
+        return CHAR_SEPARATOR;
+    }
+
+    transmitTextIndex++;
+    transmitNeedsSeparator = true;
+    transmitCode = char_to_code(c);
+    if (transmitCode == MORSE_NO_CODE)
+    {
+        // Characters without a Morse code are sent as a gap
+        transmitCode = MORSE_CODE_END;
+        return CHAR_SEPARATOR;
+    }
+    return takeCodeElement();
+}
+void transmitNextElement()
+{
+    if (currentSenderState != Transmitting)
+        return;
+
+    char element = transmitText == NULL ? nextMessageElement() : nextTextElement();
+    showMessageElement(element);
+    switch (element)
+    {
+    case DOT:
+        transmitDot();
+        break;
+    case DASH:
+        transmitDash();
+        break;
+    case CHAR_SEPARATOR:
+        transmitCharSeparator();
+        break;
+    default:
+        transmitWordSeparator();
+        break;
+    }
+}
+void startTransmittingText(const char *text)
 {
+    cancelEvent(&transmitNextElement);
+    stopKeyedMark();
+    breakText();
+
     currentSenderState = Transmitting;
+    transmitUnitMs = fastInfraredMode ? FAST_INFRARED_UNIT_MS : keyerUnitMs;
     currentMessageIndex = 0;
-    makeMultipleSound(600, 50, 4);
+    transmitText = text;
+    transmitTextIndex = 0;
+    transmitCode = MORSE_CODE_END;
+    transmitNeedsSeparator = false;
+    scheduleEvent(transmitUnitMs, &transmitNextElement);
 }
-void pushToMessage(char c)
+void startTransmitting()
+{
+    startTransmittingText(NULL);
+}
+// The keyed message is source 0, the canned text messages follow it
+unsigned char transmitSource = 0;
+
+void transmitNextSource()
+{
+    transmitSource = (transmitSource + 1) % (TEXT_MESSAGE_COUNT + 1);
+    if (transmitSource == 0)
+    {
+        startTransmitting();
+        FLASH_LED(5, UNIT_LENGTH_MS);
+    }
+    else
+    {
+        startTransmittingText(textMessages[transmitSource - 1]);
+        FLASH_LED(6, UNIT_LENGTH_MS);
+    }
+}
+// Switch between sending at the keyer's speed and the fast infrared speed, starting the current
+// message again at the new speed
+void toggleFastInfraredMode()
+{
+    fastInfraredMode = !fastInfraredMode;
+    sidetoneEnabled = !fastInfraredMode;
+    startTransmittingText(transmitText);
+    FLASH_LED(6, UNIT_LENGTH_MS);
+}
+unsigned int senderWpm()
+{
+    return WPM_UNIT_LENGTH_MS / (currentSenderState == Transmitting ? transmitUnitMs : keyerUnitMs);
+}
+char senderRoomName[5] = "K ";
+const char *senderStatusName()
+{
+    if (currentSenderState == Transmitting)
+        return "TX";
+    unsigned int left = MAX_MESSAGE_LENGTH - getMessageLength();
+    if (left > LOW_MESSAGE_ROOM)
+        return "KEY";
+    senderRoomName[2] = left >= 10 ? '0' + left / 10 : '0' + left;
+    senderRoomName[3] = left >= 10 ? '0' + left % 10 : EOS;
+    return senderRoomName;
+}
+void stopTransmitting()
 {
-    message[currentMessageIndex++] = c;
+    currentSenderState = AcceptingInput;
+    cancelEvent(&transmitNextElement);
+    stopKeyedMark();
+    breakText();
 }
-void endMessage()
+void transmitMessage()
 {
-    message[currentMessageIndex] = EOS;
+    transmitSource = 0;
+    startTransmitting();
+    makeMultipleSound(600, 150, 4);
 }
-void checkForSenderStateChange()
+void pushToMessage(char c)
 {
-    if (BUTTON_PRESSED(2))
+    pushMessageElement(c);
+    showMessageElement(c);
+
+    // When the max length is reached then send the message
+    if (isMessageFull())
+        transmitMessage();
+}
+// Set while SW2 is being used as a modifier, so its release doesn't change the sender state
+bool senderModifierUsed = false;
+
+void checkForSenderStateChange(const struct buttonEvent *event)
+{
+    // SW2 acts when it is released so it can still be combined with SW5 to change modes
+    if (event->button == 2 && !event->pressed)
     {
+        if (senderModifierUsed)
+        {
+            senderModifierUsed = false;
+            return;
+        }
         switch (currentSenderState)
         {
         case Transmitting:
-            currentSenderState = AcceptingInput;
+            stopTransmitting();
+            // Keying starts a new message
+            resetMessage();
             FLASH_2_LEDS(4, 6, UNIT_LENGTH_MS);
-            makeMultipleSound(500, 100, 2);
+            makeMultipleSound(500, 300, 2);
             break;
         case AcceptingInput:
-            currentSenderState = Transmitting;
+            transmitSource = 0;
+            startTransmitting();
             FLASH_2_LEDS(5, 6, UNIT_LENGTH_MS);
-            makeMultipleSound(800, 100, 3);
+            makeMultipleSound(800, 300, 3);
             break;
         }
-        currentMessageIndex = 0;
     }
 }
-void processSenderMode()
+
+// Returns true if the event was used in a combination with SW2
+bool checkForSenderModifier(const struct buttonEvent *event)
 {
-    TURN_ON_LED(3);
-    TURN_OFF_LED(6);
-    switch (currentSenderState)
+    if (!isButtonDown(2) || event->button == 2 || event->button == 5)
+        return false;
+
+    if (event->pressed)
     {
-    case AcceptingInput:
-        if (currentMessageIndex >= MAX_MESSAGE_LENGTH)
+        senderModifierUsed = true;
+        if (event->button == 3)
         {
-            // When the max length is reach then send the message
-            transmitMessage();
+            // SW2 + SW3 selects the next way of keying
+            nextKeyerType();
         }
-        else if (BUTTON_PRESSED(3) && BUTTON_PRESSED(4))
+        else if (event->button == 4)
         {
-            // When user ends input then send the message
-            endMessage();
+            // SW2 + SW4 ends the message and sends it
+            finishKeying();
             transmitMessage();
         }
-        else if (BUTTON_PRESSED(3))
+    }
+    return true;
+}
+
+void processButtonKeyer(const struct buttonEvent *event)
+{
+    if (event->pressed && event->button == 3)
+    {
+        pushToMessage(DOT);
+        startKeyedMark(keyerUnitMs);
+    }
+    else if (event->pressed && event->button == 4)
+    {
+        pushToMessage(DASH);
+        startKeyedMark(keyerUnitMs * 3);
+    }
+    else if (!event->pressed && event->button == 5)
+    {
+        // Like SW2, SW5 acts on release so it can be part of the mode change combination
+        pushToMessage(CHAR_SEPARATOR);
+        FLASH_LED(6, UNIT_LENGTH_MS);
+    }
+}
+
+void processSenderMode(const struct buttonEvent *event)
+{
+    switch (currentSenderState)
+    {
+    case AcceptingInput:
+        if (checkForSenderModifier(event))
+            break;
+        switch (currentKeyerType)
         {
-            pushToMessage(DOT);
-            playMorseCodeDotSound();
-            FLASH_LED(4, UNIT_LENGTH_MS);
+        case ButtonKeyer:
+            processButtonKeyer(event);
+            break;
+        case StraightKeyer:
+            processStraightKey(event);
+            break;
+        case IambicKeyerA:
+        case IambicKeyerB:
+            processIambicKey(event);
+            break;
         }
-        else if (BUTTON_PRESSED(4))
+        break;
+    case Transmitting:
+        // The message is sent by scheduled events, see transmitNextElement().  SW3 switches
+        // between the keyed message and the canned text messages, SW4 turns the sidetone off or
+        // on, and SW5 switches fast infrared mode on or off.
+        if (event->pressed && event->button == 3)
+            transmitNextSource();
+        else if (event->pressed && event->button == 4)
         {
-            pushToMessage(DASH);
-            playMorseCodeDashSound();
+            sidetoneEnabled = !sidetoneEnabled;
             FLASH_LED(5, UNIT_LENGTH_MS);
         }
-        else if (BUTTON_PRESSED(5))
-        {
-            pushToMessage(WORD_SEPARATOR);
-            FLASH_LED(6, UNIT_LENGTH_MS);
-        }
-
-        // Add a delay to reduce detecting redundant button press states
-        __delay_ms(500);
-        break;
-    case Transmitting:
-        if (currentMessageIndex < MAX_MESSAGE_LENGTH)
+        else if (!event->pressed && event->button == 5)
         {
-            char code = message[currentMessageIndex];
-            if (code != EOS)
-            {
-                switch (code)
-                {
-                case DOT:
-                    //playMorseCodeDotSound();
-                    transmitDot();
-                    break;
-                case DASH:
-                    //playMorseCodeDashSound();
-                    transmitDash();
-                    break;
-                default:
-                    transmitWordSeparator();
-                    break;
-                }
-                transmitCharSeparator();
-                currentMessageIndex++;
-            }
-            else
-                currentMessageIndex = 0;
+            // Like SW2, SW5 acts on release so it can be part of the mode change combination
+            toggleFastInfraredMode();
         }
-        else
-            currentMessageIndex = 0;
         break;
     }
-    checkForSenderStateChange();
+    checkForSenderStateChange(event);
 }
@@ -1,9 +1,4 @@
-#define EOS '\0'
-#define DOT '.'
-#define DASH '-'
-#define WORD_SEPARATOR ' '
 #define UNIT_LENGTH_MS 300
-#define MAX_MESSAGE_LENGTH 100
 
 /*
 const char *CHAR2MORSE = {".-", "-...", "-.-.", "-..", ".", "..-.", "--.",
@@ -12,23 +7,47 @@ const char *CHAR2MORSE = {".-", "-...", "-.-.", "-..", ".", "..-.", "--.",
                           "-..-", "-.--", "--.."};
                           */
 
-char message[MAX_MESSAGE_LENGTH];
-unsigned int currentMessageIndex = 0;
+// The gaps of Morse code in units: after each element, between letters and between words
+#define ELEMENT_GAP_UNITS 1
+#define LETTER_GAP_UNITS 3
+#define WORD_GAP_UNITS 7
 
 enum senderState
 {
     AcceptingInput,
     Transmitting
 };
-enum senderState currentSenderState = AcceptingInput;
+extern enum senderState currentSenderState;
+
+// Every mark is also sent on the IR LED's 38 kHz carrier, which another board's Receiver mode
+// decodes.  In fast infrared mode messages go out at this unit length (120 WPM), too fast to
+// follow by ear, so the sidetone is muted while it is on.
+#define FAST_INFRARED_UNIT_MS 10
+extern bool fastInfraredMode;
 
 void transmitDot();
 void transmitDash();
 void transmitCharSeparator();
 void transmitWordSeparator();
-void resetMessage();
+void startTransmitting();
+/**
+ * Send a text message as Morse code, repeating it until transmission is stopped.  The text is
+ * encoded one character at a time as it is sent, so it can stay in flash.  Characters that have
+ * no Morse code are sent as a character gap.
+ */
+void startTransmittingText(const char *text);
+void stopTransmitting();
+/**
+ * Returns the sender's name for the status row: TX while transmitting, otherwise KEY, or K and
+ * the number of elements left once the message has LOW_MESSAGE_ROOM or fewer to go
+ */
+const char *senderStatusName();
+#define LOW_MESSAGE_ROOM 20
+/**
+ * Returns the speed messages are being sent at, or keyed at while accepting input
+ */
+unsigned int senderWpm();
 void transmitMessage();
 void pushToMessage(char c);
-void endMessage();
-void checkForSenderStateChange();
-void processSenderMode();
+void checkForSenderStateChange(const struct buttonEvent *event);
+void processSenderMode(const struct buttonEvent *event);
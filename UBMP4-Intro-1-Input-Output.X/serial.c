@@ -0,0 +1,82 @@
+#include "xc.h"      // Microchip XC8 compiler include file
+#include "stddef.h"  // Include NULL definition
+#include "stdbool.h" // Include Boolean (true/false) definition
+#include "messageBuffer.h"
+#include "serial.h"
+
+char serialInput[SERIAL_QUEUE_SIZE];
+unsigned char serialInputHead = 0; // Written by the USB driver
+unsigned char serialInputTail = 0; // Written by getSerialLine()
+
+char serialOutput[SERIAL_QUEUE_SIZE];
+unsigned char serialOutputHead = 0; // Written by serialPutChar()
+unsigned char serialOutputTail = 0; // Written by the USB driver
+
+// The line being put together from the input
+char serialLine[SERIAL_LINE_LENGTH + 1];
+unsigned char serialLineLength = 0;
+bool serialLineComplete = false;
+
+bool serialPutChar(char c)
+{
+    unsigned char next = (serialOutputHead + 1) & (SERIAL_QUEUE_SIZE - 1);
+    if (next == serialOutputTail)
+        return false; // Nobody is reading the output, so drop it
+    serialOutput[serialOutputHead] = c;
+    serialOutputHead = next;
+    return true;
+}
+
+void serialPutString(const char *text)
+{
+    while (*text != EOS && serialPutChar(*text))
+        text++;
+}
+
+const char *getSerialLine()
+{
+    // The last line has been used, so start a new one
+    if (serialLineComplete)
+    {
+        serialLineComplete = false;
+        serialLineLength = 0;
+    }
+
+    while (serialInputTail != serialInputHead)
+    {
+        char c = serialInput[serialInputTail];
+        serialInputTail = (serialInputTail + 1) & (SERIAL_QUEUE_SIZE - 1);
+        if (c == '\r' || c == '\n')
+        {
+            // Skip the empty line between the CR and LF of a CR LF
+            if (serialLineLength == 0)
+                continue;
+            serialLine[serialLineLength] = EOS;
+            serialLineComplete = true;
+            return serialLine;
+        }
+        if (serialLineLength < SERIAL_LINE_LENGTH)
+            serialLine[serialLineLength++] = c;
+    }
+    return NULL;
+}
+
+unsigned char serialInputSpace()
+{
+    return (serialInputTail - serialInputHead - 1) & (SERIAL_QUEUE_SIZE - 1);
+}
+
+void putSerialInput(char c)
+{
+    serialInput[serialInputHead] = c;
+    serialInputHead = (serialInputHead + 1) & (SERIAL_QUEUE_SIZE - 1);
+}
+
+bool takeSerialOutput(char *c)
+{
+    if (serialOutputTail == serialOutputHead)
+        return false;
+    *c = serialOutput[serialOutputTail];
+    serialOutputTail = (serialOutputTail + 1) & (SERIAL_QUEUE_SIZE - 1);
+    return true;
+}
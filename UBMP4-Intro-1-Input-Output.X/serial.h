@@ -0,0 +1,44 @@
+// The serial channel connects the Morse code pipeline to a computer over USB (see usbCdc.h).  Text
+// goes through a ring buffer in each direction, so the firmware never waits for the computer and
+// the USB endpoints never wait for the firmware: output is dropped if the computer isn't reading
+// it, and input is left waiting in the computer until the firmware has taken what came before.
+//
+// Input is read a line at a time.  In sender mode a line of text is sent as Morse code, and in
+// any mode a line that is just '?' asks for the status shown on the LCD.
+
+// The sizes of the input and output ring buffers.  Must be powers of 2, and larger than a USB
+// packet (USB_CDC_PACKET_SIZE).
+#define SERIAL_QUEUE_SIZE 32
+
+// The longest line of input.  Longer lines are cut short.
+#define SERIAL_LINE_LENGTH 31
+
+/**
+ * Queue a character or string to be sent to the computer.  Returns false (or stops) if the
+ * output buffer is full.
+ */
+bool serialPutChar(char c);
+void serialPutString(const char *text);
+
+/**
+ * Returns the next complete line of input, without its line ending, or NULL if there isn't one
+ * yet.  The line stays valid until the next call.
+ */
+const char *getSerialLine();
+
+// For the USB driver: move characters between the ring buffers and its endpoints
+
+/**
+ * Returns the number of characters that can be added to the input
+ */
+unsigned char serialInputSpace();
+
+/**
+ * Add a character received from the computer to the input
+ */
+void putSerialInput(char c);
+
+/**
+ * Take the next character to send to the computer.  Returns false when there are none.
+ */
+bool takeSerialOutput(char *c);
@@ -0,0 +1,161 @@
+#include "xc.h"      // Microchip XC8 compiler include file
+#include "stdbool.h" // Include Boolean (true/false) definition
+#include "scheduler.h"
+#include "buttons.h"
+#include "buzzer.h"
+#include "songPlayer.h"
+#include "messageBuffer.h"
+#include "senderMode.h"
+#include "keyer.h"
+#include "receiverMode.h"
+#include "storage.h"
+#include "settings.h"
+
+// The settings as stored, packed so that three fit in a row of the store between erases.  The
+// 16-bit values are stored low byte first, and the small ones share the first byte.
+#define SETTING_FLAGS 0
+#define SETTING_KEYER_UNIT_MS 1
+#define SETTING_TEMPO_BPM 3
+#define SETTING_PERIOD_SCALE 4
+#define SETTING_SONG 6
+#define SETTINGS_BYTES 7
+
+// The fields of the first byte
+#define FLAG_MODE_MASK 0b00000011
+#define FLAG_KEYER_TYPE_SHIFT 2
+#define FLAG_KEYER_TYPE_MASK 0b00001100
+#define FLAG_SIDETONE 0b00010000
+#define FLAG_FAST_INFRARED 0b00100000
+#define FLAG_LIGHT_INPUT 0b01000000
+
+// The settings as of the last check, and as saved
+unsigned char checkedSettings[SETTINGS_BYTES];
+unsigned char savedSettings[SETTINGS_BYTES];
+unsigned char checkedMessageChanges;
+unsigned char savedMessageChanges;
+
+unsigned int lastSettingsCheckMs = 0;
+unsigned int lastSettingsChangeMs = 0;
+
+void gatherSettings(unsigned char settings[], unsigned char mode)
+{
+    settings[SETTING_FLAGS] = (mode & FLAG_MODE_MASK) |
+                              (currentKeyerType << FLAG_KEYER_TYPE_SHIFT & FLAG_KEYER_TYPE_MASK) |
+                              (sidetoneEnabled ? FLAG_SIDETONE : 0) |
+                              (fastInfraredMode ? FLAG_FAST_INFRARED : 0) |
+                              (currentReceiverSource == LightInput ? FLAG_LIGHT_INPUT : 0);
+    settings[SETTING_KEYER_UNIT_MS] = keyerUnitMs & 0xFF;
+    settings[SETTING_KEYER_UNIT_MS + 1] = keyerUnitMs >> 8;
+    settings[SETTING_TEMPO_BPM] = tempoBpm;
+    settings[SETTING_PERIOD_SCALE] = PERIOD_SCALE & 0xFF;
+    settings[SETTING_PERIOD_SCALE + 1] = PERIOD_SCALE >> 8;
+    settings[SETTING_SONG] = currentSongIndex;
+}
+
+// Apply saved settings, leaving alone any that are out of range
+void applySettings(const unsigned char settings[])
+{
+    unsigned char flags = settings[SETTING_FLAGS];
+    unsigned int unitMs = settings[SETTING_KEYER_UNIT_MS] | (unsigned int)settings[SETTING_KEYER_UNIT_MS + 1] << 8;
+    if (unitMs >= MIN_KEYER_UNIT_MS && unitMs <= MAX_KEYER_UNIT_MS)
+        keyerUnitMs = unitMs;
+    currentKeyerType = (flags & FLAG_KEYER_TYPE_MASK) >> FLAG_KEYER_TYPE_SHIFT;
+    sidetoneEnabled = (flags & FLAG_SIDETONE) != 0;
+    fastInfraredMode = (flags & FLAG_FAST_INFRARED) != 0;
+    currentReceiverSource = (flags & FLAG_LIGHT_INPUT) ? LightInput : InfraredInput;
+    if (settings[SETTING_TEMPO_BPM] >= MIN_TEMPO_BPM && settings[SETTING_TEMPO_BPM] <= MAX_TEMPO_BPM)
+        tempoBpm = settings[SETTING_TEMPO_BPM];
+    unsigned int periodScale = settings[SETTING_PERIOD_SCALE] | (unsigned int)settings[SETTING_PERIOD_SCALE + 1] << 8;
+    if (periodScale != 0)
+        PERIOD_SCALE = periodScale;
+    selectSong(settings[SETTING_SONG]);
+}
+
+// The message is stored as its length in elements followed by as many packed bytes as it fills.
+// The buffer is no bigger than the store can hold, so the whole message fits.
+void saveMessage()
+{
+    unsigned char stored[1 + MESSAGE_BUFFER_BYTES];
+    unsigned char length = (unsigned char)getMessageLength();
+    stored[0] = length;
+    unsigned char bytes = (length + 3) / 4;
+    for (unsigned char i = 0; i < bytes; i++)
+        stored[1 + i] = messageBuffer[i];
+    writeStored(STORE_KEY_MESSAGE, stored, 1 + bytes);
+}
+
+void restoreMessage()
+{
+    unsigned char stored[1 + MESSAGE_BUFFER_BYTES];
+    unsigned char length = readStored(STORE_KEY_MESSAGE, stored, sizeof(stored));
+    resetMessage();
+    if (length == 0 || length > sizeof(stored) || stored[0] > (length - 1) * 4)
+        return;
+    for (unsigned char i = 1; i < length; i++)
+        messageBuffer[i - 1] = stored[i];
+    setMessageLength(stored[0]);
+}
+
+unsigned char restoreSettings(unsigned char defaultMode)
+{
+    initStorage();
+    restoreMessage();
+    savedMessageChanges = getMessageChanges();
+
+    if (readStored(STORE_KEY_SETTINGS, savedSettings, SETTINGS_BYTES) == SETTINGS_BYTES)
+        applySettings(savedSettings);
+    else
+        gatherSettings(savedSettings, defaultMode);
+    return savedSettings[SETTING_FLAGS] & FLAG_MODE_MASK;
+}
+
+bool settingsDiffer(const unsigned char a[], const unsigned char b[])
+{
+    for (unsigned char i = 0; i < SETTINGS_BYTES; i++)
+        if (a[i] != b[i])
+            return true;
+    return false;
+}
+
+void saveSettingsWhenIdle(unsigned char mode, bool idle)
+{
+    unsigned int now = millis();
+    if ((unsigned int)(now - lastSettingsCheckMs) < SETTINGS_CHECK_MS)
+        return;
+    lastSettingsCheckMs = now;
+
+    // Wait for the settings and the message to stop changing, so a batch of changes is saved
+    // together
+    unsigned char settings[SETTINGS_BYTES];
+    gatherSettings(settings, mode);
+    if (settingsDiffer(settings, checkedSettings) || getMessageChanges() != checkedMessageChanges)
+    {
+        for (unsigned char i = 0; i < SETTINGS_BYTES; i++)
+            checkedSettings[i] = settings[i];
+        checkedMessageChanges = getMessageChanges();
+        lastSettingsChangeMs = now;
+        return;
+    }
+    if ((unsigned int)(now - lastSettingsChangeMs) < SETTINGS_SETTLE_MS || !idle)
+        return;
+
+    // Whether or not a value fits, it counts as saved, so a failed write isn't tried again and again
+    if (settingsDiffer(settings, savedSettings))
+    {
+        writeStored(STORE_KEY_SETTINGS, settings, SETTINGS_BYTES);
+        for (unsigned char i = 0; i < SETTINGS_BYTES; i++)
+            savedSettings[i] = settings[i];
+    }
+    if (checkedMessageChanges != savedMessageChanges)
+    {
+        saveMessage();
+        savedMessageChanges = checkedMessageChanges;
+    }
+}
+
+bool isSettingsSavePending(unsigned char mode)
+{
+    unsigned char settings[SETTINGS_BYTES];
+    gatherSettings(settings, mode);
+    return settingsDiffer(settings, savedSettings) || getMessageChanges() != savedMessageChanges;
+}
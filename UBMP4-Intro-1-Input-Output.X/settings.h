@@ -0,0 +1,26 @@
+// The mode, the user's speed, keyer, tone and song choices and the keyed message are kept in the
+// HEF store (see storage.h), so they survive a reset or a power loss.  Changes are saved in a
+// batch once they have stopped coming for a few seconds, and only while nothing is being sent,
+// received or played, as the CPU stops while the flash is written.
+
+// How often the settings are compared with the saved ones, and how long they must stay the
+// same before they are saved
+#define SETTINGS_CHECK_MS 500
+#define SETTINGS_SETTLE_MS 3000
+
+/**
+ * Load the settings and the message saved before the last reset.  Returns the saved mode, or
+ * defaultMode if nothing has been saved.
+ */
+unsigned char restoreSettings(unsigned char defaultMode);
+
+/**
+ * Save the settings and the message once they have settled, if idle is true.  Call on every
+ * pass of the main loop.
+ */
+void saveSettingsWhenIdle(unsigned char mode, bool idle);
+
+/**
+ * Returns true while there are changes to the settings or the message that haven't been saved
+ */
+bool isSettingsSavePending(unsigned char mode);
@@ -0,0 +1,211 @@
+#include "xc.h"      // Microchip XC8 compiler include file
+#include "stdbool.h" // Include Boolean (true/false) definition
+#include "scheduler.h"
+#include "buzzer.h"
+#include "songPlayer.h"
+
+const unsigned char westworldTheme[] = {
+    /*   0 */ SONG_OCTAVE(4), E | QuarterNote, F, E | QuarterNote, F, E, D, C | ThreeEighthNote, D | FullNote,
+    /*   9 */ D | QuarterNote, E, D | QuarterNote, E, D, C, G | HalfNote, SONG_OCTAVE(4), A | FullNote,
+    TheEnd};
+
+const unsigned char maryHadALittleLamb[] = {
+    /*   0 */ SONG_OCTAVE(4), B, A, G, A, B, B, B | QuarterNote, A,
+    /*   9 */ A, A | QuarterNote, B, D, D | QuarterNote, Rest | QuarterNote,
+    /*  15 */ SONG_REPEAT(1, 9), B, A, G | QuarterNote, G | HalfNote,
+    TheEnd};
+
+const unsigned char furElise[] = {
+    /*   0 */ SONG_OCTAVE(4), E, Ds, E, Ds, E, B, D, C,
+    /*   9 */ A | QuarterNote, Rest, C | SONG_LEAP, E, A, B | QuarterNote, Rest,
+    /*  16 */ E | SONG_LEAP, Gs, B, C | QuarterNote, Rest,
+    /*  21 */ E | SONG_LEAP, E | SONG_LEAP, SONG_REPEAT(2, 15), C | SONG_LEAP, B, A | QuarterNote, Rest,
+    /*  30 */ B, C, D, E | QuarterNote, Rest,
+    /*  35 */ G | SONG_LEAP, F | SONG_LEAP, E, D | QuarterNote, Rest,
+    /*  40 */ F | SONG_LEAP, E | SONG_LEAP, D, C | QuarterNote, Rest,
+    /*  45 */ E | SONG_LEAP, D | SONG_LEAP, C, B | SixEighthNote, Rest | HalfNote,
+    /*  50 */ SONG_REPEAT(1, 22), SONG_REPEAT(2, 15), C | SONG_LEAP, B, A | SixEighthNote, Rest | HalfNote,
+    TheEnd};
+
+const unsigned char elCondorPasa[] = {
+    /*   0 */ SONG_OCTAVE(3), B, E, Ds, E, Fs, G, Fs, G,
+    /*   9 */ A, B | HalfNote, Rest | QuarterNote, D, D | QuarterNote, B | HalfNote, Rest | QuarterNote,
+    /*  16 */ E, D | QuarterNote, B | HalfNote, Rest,
+    /*  20 */ B, A, G, A, G, E | HalfNote, Rest,
+    /*  27 */ B | SONG_LEAP, A, G, E | ThreeEighthNote, Rest | QuarterNote,
+    /*  32 */ Rest, SONG_REPEAT(1, 9), B | QuarterNote, A, G | QuarterNote, Rest | QuarterNote,
+    /*  40 */ E | SONG_LEAP, D | QuarterNote, B | HalfNote, Rest,
+    /*  44 */ E, D, E | QuarterNote, D, E, D, B | ThreeEighthNote, SONG_REPEAT(19, 8),
+    TheEnd};
+
+const unsigned char *const songs[] = {elCondorPasa, maryHadALittleLamb, westworldTheme, furElise};
+#define SONG_COUNT (sizeof(songs) / sizeof(songs[0]))
+
+// The song being played, the index of its next byte, and whether it is playing or paused
+unsigned char currentSongIndex = 0;
+unsigned char songNoteIndex;
+bool songLoaded = false;
+bool songPaused = false;
+
+// The octave and pitch of the last note played, which the next note is placed relative to,
+// and whether an octave byte has fixed the next note's octave instead
+unsigned char songOctave;
+unsigned char songPitch;
+bool songOctaveFixed;
+
+// The ticks from the start of the song to the next note, and the time that note is due.  Notes
+// are timed from the song's tick count rather than from when the last one happened to start,
+// so neither rounding nor a late main loop pass builds up over a song.
+unsigned int songTicks;
+unsigned int songNoteDueMs;
+
+// Where to carry on from once the bytes of a repeated section have been played
+unsigned char songRepeatReturn;
+unsigned char songRepeatRemaining = 0;
+
+// Returns the song's next byte, following a repeat back to the rest of the song once its
+// section has been played
+unsigned char readSongByte(const unsigned char *song)
+{
+    unsigned char songByte = song[songNoteIndex++];
+    if (songRepeatRemaining > 0 && --songRepeatRemaining == 0)
+        songNoteIndex = songRepeatReturn;
+    return songByte;
+}
+
+// Work out the octave of a note from the one before it: the nearest one, or the next one the
+// other way for a leap
+void placeSongNote(unsigned char songByte)
+{
+    unsigned char pitch = songByte & SONG_PITCH_MASK;
+    if (songOctaveFixed)
+        songOctaveFixed = false;
+    else
+    {
+        signed char interval = pitch - songPitch;
+        signed char octave = songOctave;
+        if (interval > 5)
+        {
+            octave--;
+            interval -= 12;
+        }
+        else if (interval < -6)
+        {
+            octave++;
+            interval += 12;
+        }
+        if (songByte & SONG_LEAP)
+            octave += interval > 0 ? -1 : 1;
+        songOctave = octave < 0 ? 0 : octave > MAX_OCTAVE ? MAX_OCTAVE : octave;
+    }
+    songPitch = pitch;
+}
+
+// Play the song's next note and schedule the one after it.  Octave and repeat bytes make no
+// sound, so they are applied straight away.
+void playNextSongNote()
+{
+    const unsigned char *song = songs[currentSongIndex];
+    unsigned char songByte;
+    while ((songByte = readSongByte(song)) != TheEnd)
+    {
+        unsigned char code = songByte & SONG_PITCH_MASK;
+        if (code == SONG_OCTAVE_CODE)
+        {
+            songOctave = songByte >> 4;
+            songOctaveFixed = true;
+        }
+        else if (code == SONG_REPEAT_CODE)
+        {
+            unsigned char from = song[songNoteIndex];
+            songRepeatRemaining = song[songNoteIndex + 1];
+            songRepeatReturn = songNoteIndex + 2;
+            songNoteIndex = from;
+        }
+        else
+        {
+            if (code != Rest)
+                placeSongNote(songByte);
+            currentOctave = songOctave;
+            unsigned char notePlus = code | (songByte & SONG_LENGTH_MASK);
+            unsigned int startMs = ticksToMs(songTicks);
+            songTicks += calculateNoteTicks(notePlus);
+            unsigned int lengthMs = ticksToMs(songTicks) - startMs;
+            playNoteForMs(notePlus, lengthMs - SONG_NOTE_GAP_MS);
+
+            songNoteDueMs += lengthMs;
+            unsigned int delayMs = songNoteDueMs - millis();
+            scheduleEvent((signed int)delayMs < 0 ? 0 : delayMs, &playNextSongNote);
+            return;
+        }
+    }
+
+    // The song has finished, so the next one is played next time
+    songLoaded = false;
+    currentSongIndex = (currentSongIndex + 1) % SONG_COUNT;
+}
+
+void playSong()
+{
+    stopSong();
+    songNoteIndex = 0;
+    songOctave = DEFAULT_OCTAVE;
+    songPitch = C;
+    songOctaveFixed = false;
+    songRepeatRemaining = 0;
+    songTicks = 0;
+    songNoteDueMs = millis();
+    songLoaded = true;
+    playNextSongNote();
+}
+
+void toggleSongPause()
+{
+    if (!songLoaded)
+        playSong();
+    else if (songPaused)
+    {
+        songPaused = false;
+        songNoteDueMs = millis();
+        playNextSongNote();
+    }
+    else
+    {
+        cancelEvent(&playNextSongNote);
+        stopTone();
+        songPaused = true;
+    }
+}
+
+void selectSong(unsigned char index)
+{
+    if (index < SONG_COUNT)
+        currentSongIndex = index;
+}
+
+void skipSong()
+{
+    currentSongIndex = (currentSongIndex + 1) % SONG_COUNT;
+    playSong();
+}
+
+void stopSong()
+{
+    if (songLoaded)
+    {
+        cancelEvent(&playNextSongNote);
+        stopTone();
+    }
+    songLoaded = false;
+    songPaused = false;
+}
+
+bool isSongLoaded()
+{
+    return songLoaded;
+}
+
+bool isSongPaused()
+{
+    return songPaused;
+}
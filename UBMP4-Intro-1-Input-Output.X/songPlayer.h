@@ -0,0 +1,64 @@
+// The song player steps through a song one note at a time in the background: each note is
+// started and the next one is scheduled to follow it, so the main loop keeps handling buttons
+// while a song plays.  Notes last as long as their length at tempoBpm (see buzzer.h).
+
+// Songs are kept in program memory, one byte per note.  The low nibble is the MusicalNote (C
+// to B, or Rest) and the top three bits its MusicalNoteLength, so a half note G is G | HalfNote
+// just as for playNote().  Each note is played in the octave that puts it nearest the note
+// before it (no more than 6 semitones down or 5 up); SONG_LEAP moves it to the next octave the
+// other way instead.  The other low nibble values are control bytes:
+//
+//   SONG_OCTAVE(octave)       play the next note in this octave; every song starts with one
+//   SONG_REPEAT(from, count)  play the count bytes starting at index from again.  The section
+//                             may not contain a repeat, and its first note is placed relative
+//                             to the note before the repeat unless it starts with SONG_OCTAVE.
+//   TheEnd                    the end of the song
+#define SONG_PITCH_MASK 0x0F
+#define SONG_LEAP 0x10
+#define SONG_LENGTH_MASK 0xE0
+#define SONG_OCTAVE_CODE 0x0E
+#define SONG_REPEAT_CODE 0x0F
+#define SONG_OCTAVE(octave) (SONG_OCTAVE_CODE | ((octave) << 4))
+#define SONG_REPEAT(from, count) SONG_REPEAT_CODE, (from), (count)
+
+// The silence at the end of each note of a song, so repeated notes are heard separately
+#define SONG_NOTE_GAP_MS 50
+
+// The song that plays next, as an index into the song list
+extern unsigned char currentSongIndex;
+
+/**
+ * Make a song the current one, unless the index is past the end of the song list
+ */
+void selectSong(unsigned char index);
+
+/**
+ * Play the current song from the start
+ */
+void playSong();
+
+/**
+ * Pause the song, or carry on from the next note if it is paused.  Starts the current song if
+ * none is playing.
+ */
+void toggleSongPause();
+
+/**
+ * Move to the next song and play it from the start
+ */
+void skipSong();
+
+/**
+ * Stop the song.  The next call to playSong() starts it from the beginning.
+ */
+void stopSong();
+
+/**
+ * Returns true while a song is playing or paused
+ */
+bool isSongLoaded();
+
+/**
+ * Returns true while a song is paused
+ */
+bool isSongPaused();
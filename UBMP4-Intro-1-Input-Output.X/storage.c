@@ -0,0 +1,195 @@
+#include "xc.h"      // Microchip XC8 compiler include file
+#include "stdbool.h" // Include Boolean (true/false) definition
+#include "storage.h"
+
+// An erased byte, which also marks the end of the values in a row
+#define STORE_EMPTY 0xFF
+// The top 6 bits of each word are left erased, as they aren't high endurance
+#define HEF_UNUSED_BITS 0x3F
+
+// For each key: its current row, as the offset of the row's first byte, and where its next value
+// goes.  A row starts with its sequence number, which is one more than the other row's when it
+// was started.
+unsigned char storeRowStart[STORE_KEY_COUNT];
+unsigned char storeEnd[STORE_KEY_COUNT];
+unsigned char storeSequence[STORE_KEY_COUNT];
+// False until one of the key's rows has been written
+bool storeValid[STORE_KEY_COUNT];
+
+// The bytes being written into a row, at the same offsets as in the row
+unsigned char storeRow[HEF_ROW_BYTES];
+
+unsigned char readHefByte(unsigned char offset)
+{
+    unsigned int address = HEF_ADDRESS + offset;
+    PMCON1bits.CFGS = 0;
+    PMADRH = address >> 8;
+    PMADRL = address & 0xFF;
+    PMCON1bits.RD = 1;
+    NOP();
+    NOP();
+    return PMDATL;
+}
+
+// Start the erase or write set up in PMCON1.  The CPU stops until it is done.
+void unlockFlash()
+{
+    bool interrupts = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    PMCON2 = 0x55;
+    PMCON2 = 0xAA;
+    PMCON1bits.WR = 1;
+    NOP();
+    NOP();
+    INTCONbits.GIE = interrupts;
+}
+
+void setFlashAddress(unsigned char offset)
+{
+    unsigned int address = HEF_ADDRESS + offset;
+    PMADRH = address >> 8;
+    PMADRL = address & 0xFF;
+}
+
+void eraseHefRow(unsigned char row)
+{
+    PMCON1bits.CFGS = 0;
+    setFlashAddress(row);
+    PMCON1bits.FREE = 1;
+    PMCON1bits.WREN = 1;
+    unlockFlash();
+    PMCON1bits.WREN = 0;
+    PMCON1bits.FREE = 0;
+}
+
+// Program bytes first to end - 1 of storeRow into the row.  Only their latches are loaded: the
+// others stay erased (0x3FFF) and leave their words alone, so no word is programmed twice
+// between erases.  The last word loaded writes the row.
+void writeHefRow(unsigned char row, unsigned char first, unsigned char end)
+{
+    PMCON1bits.CFGS = 0;
+    PMCON1bits.FREE = 0;
+    PMCON1bits.WREN = 1;
+    PMCON1bits.LWLO = 1;
+    for (unsigned char i = first; i < end; i++)
+    {
+        setFlashAddress(row + i);
+        PMDATH = HEF_UNUSED_BITS;
+        PMDATL = storeRow[i];
+        if (i == end - 1)
+            PMCON1bits.LWLO = 0;
+        unlockFlash();
+    }
+    PMCON1bits.WREN = 0;
+}
+
+// A record is its length, its value and the complement of the sum of both.  A record whose
+// writing was cut short ends in erased bytes, which won't match.
+bool isRecordValid(unsigned char offset)
+{
+    unsigned char length = readHefByte(offset);
+    unsigned char sum = 0;
+    for (unsigned char i = 0; i < length + 1; i++)
+        sum += readHefByte(offset + i);
+    return readHefByte(offset + length + 1) == (unsigned char)~sum;
+}
+
+// Put a record into storeRow at offset.  Returns the offset after it.
+unsigned char fillRecord(unsigned char offset, const unsigned char *value, unsigned char length)
+{
+    unsigned char sum = length;
+    storeRow[offset++] = length;
+    for (unsigned char i = 0; i < length; i++)
+    {
+        storeRow[offset++] = value[i];
+        sum += value[i];
+    }
+    storeRow[offset++] = ~sum;
+    return offset;
+}
+
+unsigned char nextSequence(unsigned char sequence)
+{
+    return sequence == STORE_EMPTY - 1 ? 0 : sequence + 1;
+}
+
+void initStorage()
+{
+    for (unsigned char k = 0; k < STORE_KEY_COUNT; k++)
+    {
+        unsigned char area = k * STORE_AREA_BYTES;
+        unsigned char first = readHefByte(area);
+        unsigned char second = readHefByte(area + HEF_ROW_BYTES);
+        storeValid[k] = first != STORE_EMPTY || second != STORE_EMPTY;
+        if (!storeValid[k])
+            continue;
+
+        // When both rows are in use, the second was started after the first or the other way round
+        bool useSecond = first == STORE_EMPTY || (second != STORE_EMPTY && second == nextSequence(first));
+        storeRowStart[k] = useSecond ? area + HEF_ROW_BYTES : area;
+        storeSequence[k] = useSecond ? second : first;
+
+        // The values end at the first erased byte, or at a length that runs off the row
+        unsigned char offset = 1;
+        while (offset < HEF_ROW_BYTES && readHefByte(storeRowStart[k] + offset) != STORE_EMPTY)
+        {
+            unsigned char next = offset + readHefByte(storeRowStart[k] + offset) + STORE_RECORD_OVERHEAD;
+            if (next > HEF_ROW_BYTES || next < offset)
+                break;
+            offset = next;
+        }
+        storeEnd[k] = offset;
+    }
+}
+
+unsigned char readStored(unsigned char key, unsigned char *value, unsigned char size)
+{
+    unsigned char k = key - 1;
+    if (!storeValid[k])
+        return 0;
+
+    // The newest valid record in the row counts
+    unsigned char found = 0;
+    for (unsigned char offset = 1; offset < storeEnd[k];
+         offset += readHefByte(storeRowStart[k] + offset) + STORE_RECORD_OVERHEAD)
+    {
+        if (isRecordValid(storeRowStart[k] + offset))
+            found = storeRowStart[k] + offset;
+    }
+    if (found == 0)
+        return 0;
+    unsigned char length = readHefByte(found);
+    for (unsigned char i = 0; i < length && i < size; i++)
+        value[i] = readHefByte(found + 1 + i);
+    return length;
+}
+
+bool writeStored(unsigned char key, const unsigned char *value, unsigned char length)
+{
+    unsigned char k = key - 1;
+    if (length > STORE_MAX_VALUE_BYTES)
+        return false;
+
+    if (storeValid[k] && storeEnd[k] + length + STORE_RECORD_OVERHEAD <= HEF_ROW_BYTES)
+    {
+        unsigned char end = fillRecord(storeEnd[k], value, length);
+        writeHefRow(storeRowStart[k], storeEnd[k], end);
+        storeEnd[k] = end;
+        return true;
+    }
+
+    // Start the key's other row.  The sequence number goes in last, so the row is only used once
+    // the value is in it.
+    unsigned char row = storeValid[k] ? storeRowStart[k] ^ HEF_ROW_BYTES : k * STORE_AREA_BYTES;
+    eraseHefRow(row);
+    unsigned char end = fillRecord(1, value, length);
+    writeHefRow(row, 1, end);
+    storeSequence[k] = storeValid[k] ? nextSequence(storeSequence[k]) : 0;
+    storeRow[0] = storeSequence[k];
+    writeHefRow(row, 0, 1);
+
+    storeRowStart[k] = row;
+    storeEnd[k] = end;
+    storeValid[k] = true;
+    return true;
+}
@@ -0,0 +1,44 @@
+// A small key/value store in the PIC16F1459's high-endurance flash (HEF): the last 128 words of
+// program memory, four rows of 32 words.  Only the low byte of each word is high endurance
+// (100,000 erases rather than 10,000), so the store holds a byte per word.  The linker must keep
+// code out of it (see the ROM ranges in morseCode.c).
+//
+// Each key has two rows of its own, used in turn.  New values are added to the end of the
+// current row without erasing anything, and the newest value is the one that counts.  When the
+// row is full the other row is erased and the new value starts it, so the two rows share the
+// key's erases, and a key that changes often doesn't make another key's values be copied.  A
+// value cut short by a power loss fails its checksum and the one before it is used instead.
+//
+// While flash is erased or written the CPU stops for about 2 ms (interrupts included), so only
+// write when nothing is being timed.
+
+#define HEF_ADDRESS 0x1F80
+#define HEF_ROW_BYTES 32
+#define HEF_BYTES 128
+
+// The keys stored, numbered from 1.  Each key's rows start STORE_AREA_BYTES after the last's.
+#define STORE_KEY_SETTINGS 1
+#define STORE_KEY_MESSAGE 2
+#define STORE_KEY_COUNT 2
+#define STORE_AREA_BYTES (2 * HEF_ROW_BYTES)
+
+// Each value takes 2 bytes more than its length (length and checksum), and a row starts with a
+// byte that says which of the key's rows is newer, so a value can be up to 29 bytes
+#define STORE_RECORD_OVERHEAD 2
+#define STORE_MAX_VALUE_BYTES (HEF_ROW_BYTES - 1 - STORE_RECORD_OVERHEAD)
+
+/**
+ * Find the values written before the last reset.  Call once at start-up.
+ */
+void initStorage();
+
+/**
+ * Copy the newest value of a key into value, up to size bytes.  Returns the length of the
+ * value, or 0 if the key has never been written.
+ */
+unsigned char readStored(unsigned char key, unsigned char *value, unsigned char size);
+
+/**
+ * Add a new value for a key.  Returns false if the value is longer than STORE_MAX_VALUE_BYTES.
+ */
+bool writeStored(unsigned char key, const unsigned char *value, unsigned char length);
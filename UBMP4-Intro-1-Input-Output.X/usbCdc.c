@@ -0,0 +1,475 @@
+#include "xc.h"      // Microchip XC8 compiler include file
+#include "stddef.h"  // Include NULL definition
+#include "stdbool.h" // Include Boolean (true/false) definition
+#include "serial.h"
+#include "usbCdc.h"
+
+// A buffer descriptor: the USB module and the firmware hand each endpoint buffer back and forth
+// by the UOWN bit of its status
+struct bufferDescriptor
+{
+    unsigned char stat;
+    unsigned char cnt;
+    unsigned char adrl;
+    unsigned char adrh;
+};
+
+// Buffer descriptor status bits
+#define BD_UOWN 0x80   // The USB module owns the buffer
+#define BD_DTS 0x40    // DATA1 rather than DATA0
+#define BD_DTSEN 0x08  // Ignore packets with the wrong data toggle
+#define BD_BSTALL 0x04 // Answer with a STALL
+#define BD_PID(stat) (((stat) >> 2) & 0x0F)
+#define PID_SETUP 0x0D
+
+// The buffer descriptor table is fixed at the start of the USB RAM, one descriptor per endpoint
+// and direction, as the ping-pong buffers are off.  The buffers follow it in the same bank, at
+// the linear addresses their descriptors point at.
+#define BDT_ADDRESS 0x2000
+#define EP0_OUT_BUFFER 0x2018
+#define EP0_IN_BUFFER 0x2020
+#define EP1_IN_BUFFER 0x2028
+#define EP2_OUT_BUFFER 0x2030
+#define EP2_IN_BUFFER 0x2040
+
+#define EP0_PACKET_SIZE 8
+#define EP1_PACKET_SIZE 8
+
+#define BD_EP0_OUT 0
+#define BD_EP0_IN 1
+#define BD_EP1_IN 3
+#define BD_EP2_OUT 4
+#define BD_EP2_IN 5
+#define BD_COUNT 6
+
+volatile struct bufferDescriptor usbBdt[BD_COUNT] __at(BDT_ADDRESS);
+volatile unsigned char ep0OutBuffer[EP0_PACKET_SIZE] __at(EP0_OUT_BUFFER);
+volatile unsigned char ep0InBuffer[EP0_PACKET_SIZE] __at(EP0_IN_BUFFER);
+volatile unsigned char ep2OutBuffer[USB_CDC_PACKET_SIZE] __at(EP2_OUT_BUFFER);
+volatile unsigned char ep2InBuffer[USB_CDC_PACKET_SIZE] __at(EP2_IN_BUFFER);
+
+// Endpoint control values: handshaking on, with control transfers only on endpoint 0
+#define UEP_CONTROL 0x16  // EPHSHK, EPOUTEN, EPINEN
+#define UEP_IN_ONLY 0x1A  // EPHSHK, EPCONDIS, EPINEN
+#define UEP_IN_OUT 0x1E   // EPHSHK, EPCONDIS, EPOUTEN, EPINEN
+
+// Standard and CDC class requests
+#define GET_STATUS 0x00
+#define CLEAR_FEATURE 0x01
+#define SET_FEATURE 0x03
+#define SET_ADDRESS 0x05
+#define GET_DESCRIPTOR 0x06
+#define GET_CONFIGURATION 0x08
+#define SET_CONFIGURATION 0x09
+#define GET_INTERFACE 0x0A
+#define SET_INTERFACE 0x0B
+#define SET_LINE_CODING 0x20
+#define GET_LINE_CODING 0x21
+#define SET_CONTROL_LINE_STATE 0x22
+#define SEND_BREAK 0x23
+#define REQUEST_TYPE_MASK 0x60
+#define REQUEST_TYPE_STANDARD 0x00
+#define REQUEST_TYPE_CLASS 0x20
+
+#define DEVICE_DESCRIPTOR 1
+#define CONFIGURATION_DESCRIPTOR 2
+#define STRING_DESCRIPTOR 3
+
+// Microchip's vendor ID and the product ID of its CDC examples, which operating systems already
+// know as a serial port.  A board that is given away needs a product ID of its own.
+const unsigned char deviceDescriptor[] = {
+    18, DEVICE_DESCRIPTOR,
+    0x00, 0x02, // USB 2.0
+    0x02,       // Communications device class
+    0x00, 0x00,
+    EP0_PACKET_SIZE,
+    0xD8, 0x04, // Vendor ID
+    0x0A, 0x00, // Product ID
+    0x00, 0x01, // Device release 1.00
+    0,          // No manufacturer string
+    1,          // Product string
+    0,          // No serial number
+    1,          // One configuration
+};
+
+#define CONFIGURATION_LENGTH 67
+const unsigned char configurationDescriptor[CONFIGURATION_LENGTH] = {
+    9, CONFIGURATION_DESCRIPTOR, CONFIGURATION_LENGTH, 0,
+    2,    // Two interfaces
+    1,    // Configuration value
+    0,    // No configuration string
+    0x80, // Bus powered
+    50,   // 100 mA
+
+    // Interface 0: communications class, abstract control model
+    9, 4, 0, 0, 1, 0x02, 0x02, 0x01, 0,
+    5, 0x24, 0x00, 0x10, 0x01, // Header: CDC 1.10
+    5, 0x24, 0x01, 0x00, 0x01, // Call management: none, data on interface 1
+    4, 0x24, 0x02, 0x02,       // Abstract control management: line coding and control line state
+    5, 0x24, 0x06, 0, 1,       // Union: interface 0 controls interface 1
+    7, 5, 0x81, 0x03, EP1_PACKET_SIZE, 0, 0xFF, // Endpoint 1 IN, interrupt (never used)
+
+    // Interface 1: data class
+    9, 4, 1, 0, 2, 0x0A, 0x00, 0x00, 0,
+    7, 5, 0x02, 0x02, USB_CDC_PACKET_SIZE, 0, 0, // Endpoint 2 OUT, bulk
+    7, 5, 0x82, 0x02, USB_CDC_PACKET_SIZE, 0, 0, // Endpoint 2 IN, bulk
+};
+
+const unsigned char languageString[] = {4, STRING_DESCRIPTOR, 0x09, 0x04}; // US English
+const unsigned char productString[] = {
+    34, STRING_DESCRIPTOR,
+    'U', 0, 'B', 0, 'M', 0, 'P', 0, '4', 0, ' ', 0, 'M', 0, 'o', 0,
+    'r', 0, 's', 0, 'e', 0, ' ', 0, 'C', 0, 'o', 0, 'd', 0, 'e', 0,
+};
+
+// The line settings the computer last set: 9600 baud, 1 stop bit, no parity, 8 data bits
+unsigned char lineCoding[7] = {0x80, 0x25, 0x00, 0x00, 0, 0, 8};
+
+unsigned char usbConfiguration = 0;
+unsigned char pendingAddress = 0;
+
+// What is left of the reply being sent on endpoint 0.  A reply shorter than the computer asked
+// for has to end with a short packet, which is zero length when the reply fills its last packet.
+const unsigned char *ep0Data;
+unsigned char ep0Remaining;
+bool ep0NeedsShortPacket;
+bool ep0InData1;
+// Set while the data stage of a SET_LINE_CODING is expected
+bool receivingLineCoding = false;
+
+bool ep2OutArmed;
+bool ep2OutData1;
+bool ep2InBusy;
+bool ep2InData1;
+
+void armEp0Out()
+{
+    usbBdt[BD_EP0_OUT].cnt = EP0_PACKET_SIZE;
+    usbBdt[BD_EP0_OUT].stat = BD_UOWN;
+}
+
+void stallEp0()
+{
+    usbBdt[BD_EP0_OUT].cnt = EP0_PACKET_SIZE;
+    usbBdt[BD_EP0_OUT].stat = BD_UOWN | BD_BSTALL;
+    usbBdt[BD_EP0_IN].stat = BD_UOWN | BD_BSTALL;
+}
+
+// Send the next packet of the reply on endpoint 0, if there is one
+void sendEp0Packet()
+{
+    if (ep0Remaining == 0 && !ep0NeedsShortPacket)
+        return;
+
+    unsigned char count = ep0Remaining < EP0_PACKET_SIZE ? ep0Remaining : EP0_PACKET_SIZE;
+    for (unsigned char i = 0; i < count; i++)
+        ep0InBuffer[i] = *ep0Data++;
+    ep0Remaining -= count;
+    if (count < EP0_PACKET_SIZE)
+        ep0NeedsShortPacket = false;
+
+    usbBdt[BD_EP0_IN].cnt = count;
+    usbBdt[BD_EP0_IN].stat = BD_UOWN | BD_DTSEN | (ep0InData1 ? BD_DTS : 0);
+    ep0InData1 = !ep0InData1;
+}
+
+// Start the data stage of a control read, sending no more than the computer asked for
+void replyEp0(const unsigned char *data, unsigned char length, unsigned int requested)
+{
+    ep0Data = data;
+    ep0Remaining = requested < length ? requested : length;
+    ep0NeedsShortPacket = requested > length;
+    ep0InData1 = true;
+    sendEp0Packet();
+}
+
+// The status stage of a control write is a zero-length DATA1 packet
+void acknowledgeEp0()
+{
+    replyEp0(NULL, 0, 1);
+}
+
+void configureEndpoints()
+{
+    UEP1 = UEP_IN_ONLY;
+    UEP2 = UEP_IN_OUT;
+    usbBdt[BD_EP1_IN].adrl = EP1_IN_BUFFER & 0xFF;
+    usbBdt[BD_EP1_IN].adrh = EP1_IN_BUFFER >> 8;
+    usbBdt[BD_EP1_IN].stat = 0;
+    usbBdt[BD_EP2_OUT].adrl = EP2_OUT_BUFFER & 0xFF;
+    usbBdt[BD_EP2_OUT].adrh = EP2_OUT_BUFFER >> 8;
+    usbBdt[BD_EP2_OUT].stat = 0;
+    usbBdt[BD_EP2_IN].adrl = EP2_IN_BUFFER & 0xFF;
+    usbBdt[BD_EP2_IN].adrh = EP2_IN_BUFFER >> 8;
+    usbBdt[BD_EP2_IN].stat = 0;
+    ep2OutArmed = false;
+    ep2OutData1 = false;
+    ep2InBusy = false;
+    ep2InData1 = false;
+}
+
+void handleStandardRequest(unsigned char request, unsigned char value, unsigned char valueHigh, unsigned int length)
+{
+    static const unsigned char zeros[2] = {0, 0};
+    switch (request)
+    {
+    case GET_STATUS:
+        replyEp0(zeros, 2, length);
+        break;
+    case CLEAR_FEATURE:
+    case SET_FEATURE:
+    case SET_INTERFACE:
+        acknowledgeEp0();
+        break;
+    case SET_ADDRESS:
+        // The new address only applies once the status stage has gone at the old one
+        pendingAddress = value;
+        acknowledgeEp0();
+        break;
+    case GET_DESCRIPTOR:
+        if (valueHigh == DEVICE_DESCRIPTOR)
+            replyEp0(deviceDescriptor, sizeof(deviceDescriptor), length);
+        else if (valueHigh == CONFIGURATION_DESCRIPTOR)
+            replyEp0(configurationDescriptor, sizeof(configurationDescriptor), length);
+        else if (valueHigh == STRING_DESCRIPTOR && value == 0)
+            replyEp0(languageString, sizeof(languageString), length);
+        else if (valueHigh == STRING_DESCRIPTOR && value == 1)
+            replyEp0(productString, sizeof(productString), length);
+        else
+            stallEp0();
+        break;
+    case GET_CONFIGURATION:
+        replyEp0(&usbConfiguration, 1, length);
+        break;
+    case SET_CONFIGURATION:
+        usbConfiguration = value;
+        if (usbConfiguration != 0)
+            configureEndpoints();
+        acknowledgeEp0();
+        break;
+    case GET_INTERFACE:
+        replyEp0(zeros, 1, length);
+        break;
+    default:
+        stallEp0();
+        break;
+    }
+}
+
+void handleClassRequest(unsigned char request, unsigned int length)
+{
+    switch (request)
+    {
+    case SET_LINE_CODING:
+        // The settings come in the data stage, to endpoint 0's OUT buffer
+        receivingLineCoding = true;
+        break;
+    case GET_LINE_CODING:
+        replyEp0(lineCoding, sizeof(lineCoding), length);
+        break;
+    case SET_CONTROL_LINE_STATE:
+    case SEND_BREAK:
+        acknowledgeEp0();
+        break;
+    default:
+        stallEp0();
+        break;
+    }
+}
+
+void handleSetup()
+{
+    unsigned char requestType = ep0OutBuffer[0];
+    unsigned char request = ep0OutBuffer[1];
+    unsigned int length = ep0OutBuffer[6] | (unsigned int)ep0OutBuffer[7] << 8;
+
+    // A setup cancels whatever endpoint 0 was doing
+    usbBdt[BD_EP0_IN].stat = 0;
+    ep0Remaining = 0;
+    ep0NeedsShortPacket = false;
+    receivingLineCoding = false;
+    armEp0Out();
+
+    if ((requestType & REQUEST_TYPE_MASK) == REQUEST_TYPE_STANDARD)
+        handleStandardRequest(request, ep0OutBuffer[2], ep0OutBuffer[3], length);
+    else if ((requestType & REQUEST_TYPE_MASK) == REQUEST_TYPE_CLASS)
+        handleClassRequest(request, length);
+    else
+        stallEp0();
+
+    // The USB module stops handling packets after each setup until it is told to carry on
+    UCONbits.PKTDIS = 0;
+}
+
+void handleEp0Out()
+{
+    if (BD_PID(usbBdt[BD_EP0_OUT].stat) == PID_SETUP)
+    {
+        handleSetup();
+        return;
+    }
+
+    // The data stage of a SET_LINE_CODING, or the status stage of a control read
+    if (receivingLineCoding)
+    {
+        for (unsigned char i = 0; i < sizeof(lineCoding) && i < usbBdt[BD_EP0_OUT].cnt; i++)
+            lineCoding[i] = ep0OutBuffer[i];
+        receivingLineCoding = false;
+        acknowledgeEp0();
+    }
+    armEp0Out();
+}
+
+void handleEp0In()
+{
+    if (pendingAddress != 0)
+    {
+        UADDR = pendingAddress;
+        pendingAddress = 0;
+    }
+    sendEp0Packet();
+}
+
+void handleEp2Out()
+{
+    unsigned char count = usbBdt[BD_EP2_OUT].cnt;
+    for (unsigned char i = 0; i < count; i++)
+        putSerialInput(ep2OutBuffer[i]);
+    ep2OutArmed = false;
+}
+
+void handleBusReset()
+{
+    UADDR = 0;
+    UEIR = 0;
+    // Throw away any transfers still queued in USTAT
+    while (UIRbits.TRNIF)
+        UIRbits.TRNIF = 0;
+
+    UEP0 = UEP_CONTROL;
+    UEP1 = 0;
+    UEP2 = 0;
+    usbBdt[BD_EP0_OUT].adrl = EP0_OUT_BUFFER & 0xFF;
+    usbBdt[BD_EP0_OUT].adrh = EP0_OUT_BUFFER >> 8;
+    usbBdt[BD_EP0_IN].adrl = EP0_IN_BUFFER & 0xFF;
+    usbBdt[BD_EP0_IN].adrh = EP0_IN_BUFFER >> 8;
+    usbBdt[BD_EP0_IN].stat = 0;
+    armEp0Out();
+
+    usbConfiguration = 0;
+    pendingAddress = 0;
+    ep0Remaining = 0;
+    ep0NeedsShortPacket = false;
+    receivingLineCoding = false;
+    UCONbits.PKTDIS = 0;
+    UIRbits.URSTIF = 0;
+}
+
+void initUsbCdc()
+{
+    UCON = 0;
+    UIE = 0;
+    UCFG = 0b00010100; // Pull-up on, full speed, ping-pong buffers off
+    for (unsigned char i = 0; i < BD_COUNT; i++)
+        usbBdt[i].stat = 0;
+    UCONbits.USBEN = 1;
+    handleBusReset();
+}
+
+// Move text between the serial channel and the bulk endpoints
+void serviceBulkEndpoints()
+{
+    if (!ep2OutArmed && serialInputSpace() >= USB_CDC_PACKET_SIZE)
+    {
+        // Until there is room for a whole packet the computer's packets are NAK'd, so it waits
+        usbBdt[BD_EP2_OUT].cnt = USB_CDC_PACKET_SIZE;
+        usbBdt[BD_EP2_OUT].stat = BD_UOWN | BD_DTSEN | (ep2OutData1 ? BD_DTS : 0);
+        ep2OutData1 = !ep2OutData1;
+        ep2OutArmed = true;
+    }
+
+    if (!ep2InBusy)
+    {
+        unsigned char count = 0;
+        char c;
+        while (count < USB_CDC_PACKET_SIZE - 1 && takeSerialOutput(&c))
+            ep2InBuffer[count++] = c;
+        if (count > 0)
+        {
+            usbBdt[BD_EP2_IN].cnt = count;
+            usbBdt[BD_EP2_IN].stat = BD_UOWN | BD_DTSEN | (ep2InData1 ? BD_DTS : 0);
+            ep2InData1 = !ep2InData1;
+            ep2InBusy = true;
+        }
+    }
+}
+
+void serviceUsbCdc()
+{
+    if (UIRbits.URSTIF)
+        handleBusReset();
+    if (UIRbits.STALLIF)
+    {
+        // A setup has arrived at the stalled endpoint 0, which clears the stall
+        if (UEP0bits.EPSTALL)
+            UEP0bits.EPSTALL = 0;
+        UIRbits.STALLIF = 0;
+    }
+    // Suspend, resume, start of frame and error events aren't used.  The flags are cleared one at
+    // a time so that a transfer finishing meanwhile can't be cleared with them.
+    UIRbits.IDLEIF = 0;
+    UIRbits.ACTVIF = 0;
+    UIRbits.SOFIF = 0;
+    UIRbits.UERRIF = 0;
+    UEIR = 0;
+
+    while (UIRbits.TRNIF)
+    {
+        // USTAT holds the endpoint and direction, which give the buffer descriptor's index, and
+        // moves on to the next transfer once TRNIF is cleared
+        unsigned char bd = (USTAT >> 2) & 0b00011111;
+        UIRbits.TRNIF = 0;
+        switch (bd)
+        {
+        case BD_EP0_OUT:
+            handleEp0Out();
+            break;
+        case BD_EP0_IN:
+            handleEp0In();
+            break;
+        case BD_EP2_OUT:
+            handleEp2Out();
+            break;
+        case BD_EP2_IN:
+            ep2InBusy = false;
+            break;
+        }
+    }
+
+    if (usbConfiguration != 0)
+        serviceBulkEndpoints();
+}
+
+bool prepareUsbCdcForSleep()
+{
+    // A device that has been given an address is still being set up by the computer
+    if (usbConfiguration != 0 || UADDR != 0)
+        return false;
+    UIRbits.ACTVIF = 0;
+    UIEbits.ACTVIE = 1;
+    PIE2bits.USBIE = 1;
+    UCONbits.SUSPND = 1; // Stop the module's clock; it can still see activity on the bus
+    return true;
+}
+
+bool resumeUsbCdc()
+{
+    bool activity = UIRbits.ACTVIF;
+    UCONbits.SUSPND = 0;
+    PIE2bits.USBIE = 0;
+    UIEbits.ACTVIE = 0;
+    // ACTVIF can't be cleared until the module's clock has started again
+    while (UIRbits.ACTVIF)
+        UIRbits.ACTVIF = 0;
+    return activity;
+}
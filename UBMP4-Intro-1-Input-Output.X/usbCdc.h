@@ -0,0 +1,38 @@
+// A USB CDC-ACM (virtual serial port) device on the PIC16F1459's USB module, carrying the serial
+// channel's text (see serial.h).  A computer sees it as /dev/ttyACM<n> or a COM port; the baud
+// rate and other line settings are accepted and ignored.
+//
+// The driver is polled from the main loop rather than run from the USB interrupt, so it never
+// adds to the tick interrupt's latency.  The USB module answers with NAKs until a transfer has
+// been dealt with, and every main loop pass is far shorter than the time a computer gives a
+// device to answer.  The bulk endpoints' packets are small (USB_CDC_PACKET_SIZE), which keeps
+// the buffers within the first bank of the USB RAM next to the buffer descriptor table.
+
+// The size of the bulk data endpoints' packets.  Packets sent to the computer carry one less, so
+// every one is a short packet that ends its transfer and no zero-length packets are needed.
+#define USB_CDC_PACKET_SIZE 16
+
+/**
+ * Attach to the USB bus.  The computer finds the device and configures it some time after this,
+ * as serviceUsbCdc() answers it.
+ */
+void initUsbCdc();
+
+/**
+ * Deal with everything the USB module has done since the last call, and move text between the
+ * serial channel and the bulk endpoints.  Call on every pass of the main loop.
+ */
+void serviceUsbCdc();
+
+/**
+ * Get ready for the PIC to sleep, if no computer has configured the device: suspend the USB
+ * module and have bus activity (a computer being plugged in) wake the PIC.  Returns false, and
+ * changes nothing, while a computer is using the port, as the PIC mustn't sleep then.
+ */
+bool prepareUsbCdcForSleep();
+
+/**
+ * Bring the USB module out of suspend after the PIC wakes.  Call after every sleep that
+ * prepareUsbCdcForSleep() allowed.  Returns true if there was activity on the bus.
+ */
+bool resumeUsbCdc();